@@ -0,0 +1,615 @@
+#include <engine/clustered_lighting.hpp>
+#include <engine/compute_primitives.hpp>
+#include <engine/gl.hpp>
+#include <engine/headless_context.hpp>
+#include <engine/uniform_allocator.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Every iteration ends with glFinish(), so upload/copy numbers are end-to-end latency including the driver's work,
+// not just the time to enqueue the command. Bind benchmarks only finish once per batch.
+
+static constexpr int64_t MinSize = 64;
+static constexpr int64_t MaxSize = int64_t(256) << 20;
+
+static void SizeArgs(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(16)->Range(MinSize, MaxSize)->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+static std::vector<uint8_t> MakeData(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) data[i] = static_cast<uint8_t>(i * 31);
+    return data;
+}
+
+static void BM_BufferSet(benchmark::State& state) {
+    auto size   = static_cast<size_t>(state.range(0));
+    auto data   = MakeData(size);
+    auto buffer = glw::Buffer::createUnique(size, nullptr, glw::Buffer::Usage::DynamicDraw);
+
+    for (auto _ : state) {
+        buffer->set(size, data.data());
+        glFinish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferSet)->Apply(SizeArgs);
+
+static void BM_BufferSetRealloc(benchmark::State& state) {
+    auto size   = static_cast<size_t>(state.range(0));
+    auto data   = MakeData(size);
+    auto buffer = glw::Buffer::createUnique(size, nullptr, glw::Buffer::Usage::DynamicDraw);
+
+    bool toggle = false;
+    for (auto _ : state) {
+        buffer->set(toggle ? size : size - 16, data.data());
+        toggle = !toggle;
+        glFinish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferSetRealloc)->Apply(SizeArgs);
+
+static void BM_BufferSubdata(benchmark::State& state) {
+    auto size   = static_cast<size_t>(state.range(0));
+    auto data   = MakeData(size);
+    auto buffer = glw::Buffer::createStorageUnique(size, nullptr, glw::Buffer::StorageFlags::DynamicStorage);
+
+    for (auto _ : state) {
+        buffer->subdata(size, data.data());
+        glFinish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferSubdata)->Apply(SizeArgs);
+
+static void BM_BufferStorage(benchmark::State& state) {
+    auto size = static_cast<size_t>(state.range(0));
+    auto data = MakeData(size);
+
+    for (auto _ : state) {
+        auto buffer = glw::Buffer::createStorageUnique(size, data.data(), glw::Buffer::StorageFlags::None);
+        glFinish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferStorage)->Apply(SizeArgs);
+
+static void BM_BufferMapFlush(benchmark::State& state) {
+    auto size   = static_cast<size_t>(state.range(0));
+    auto data   = MakeData(size);
+    auto buffer = glw::Buffer::createStorageUnique(size, nullptr, glw::Buffer::StorageFlags::MapWrite);
+
+    for (auto _ : state) {
+        void* ptr = buffer->map(GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_INVALIDATE_RANGE_BIT, {0, size});
+        std::memcpy(ptr, data.data(), size);
+        buffer->flushMappedRange({0, size});
+        buffer->unmap();
+        glFinish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferMapFlush)->Apply(SizeArgs);
+
+static void BM_BufferPersistentWrite(benchmark::State& state) {
+    auto size   = static_cast<size_t>(state.range(0));
+    auto data   = MakeData(size);
+    auto flags  = glw::Buffer::StorageFlags::MapWrite | glw::Buffer::StorageFlags::MapPersistent | glw::Buffer::StorageFlags::MapCoherent;
+    auto buffer = glw::Buffer::createStorageUnique(size, nullptr, flags);
+    void* ptr   = buffer->map(GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, {0, size});
+
+    for (auto _ : state) {
+        std::memcpy(ptr, data.data(), size);
+        glw::Fence fence;
+        fence.wait(UINT64_MAX);
+    }
+
+    buffer->unmap();
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferPersistentWrite)->Apply(SizeArgs);
+
+static void BM_BufferCopyTo(benchmark::State& state) {
+    auto size        = static_cast<size_t>(state.range(0));
+    auto source      = glw::Buffer::createStorageUnique(size, nullptr, glw::Buffer::StorageFlags::None);
+    auto destination = glw::Buffer::createStorageUnique(size, nullptr, glw::Buffer::StorageFlags::None);
+
+    for (auto _ : state) {
+        source->copyTo(destination);
+        glFinish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferCopyTo)->Apply(SizeArgs);
+
+static void BM_BufferClear(benchmark::State& state) {
+    auto     size   = static_cast<size_t>(state.range(0));
+    auto     buffer = glw::Buffer::createStorageUnique(size, nullptr, glw::Buffer::StorageFlags::None);
+    uint32_t value  = 0xDEADBEEF;
+
+    for (auto _ : state) {
+        buffer->clear(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &value);
+        glFinish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferClear)->Apply(SizeArgs);
+
+static void BM_BufferGetSubData(benchmark::State& state) {
+    auto size   = static_cast<size_t>(state.range(0));
+    auto data   = MakeData(size);
+    auto buffer = glw::Buffer::createStorageUnique(size, data.data(), glw::Buffer::StorageFlags::None);
+
+    for (auto _ : state) {
+        auto memory = buffer->getSubData({0, size});
+        benchmark::DoNotOptimize(memory.data);
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_BufferGetSubData)->Apply(SizeArgs);
+
+static void BM_VertexArraySetup(benchmark::State& state) {
+    auto attributes = static_cast<size_t>(state.range(0));
+    auto buffer     = glw::Buffer::createStorageUnique(4096, nullptr, glw::Buffer::StorageFlags::None);
+
+    std::vector<size_t> sizes(attributes, 4);
+    for (auto _ : state) {
+        glw::VertexArray vertexArray;
+        vertexArray.bindVertexBuffer(buffer.get(), sizes);
+        vertexArray.bindElementBuffer(buffer.get());
+    }
+    glFinish();
+}
+BENCHMARK(BM_VertexArraySetup)->RangeMultiplier(2)->Range(1, 16);
+
+static void BM_VertexArrayBindChurn(benchmark::State& state) {
+    auto count  = static_cast<size_t>(state.range(0));
+    auto buffer = glw::Buffer::createStorageUnique(4096, nullptr, glw::Buffer::StorageFlags::None);
+
+    std::vector<std::unique_ptr<glw::VertexArray>> vertexArrays;
+    for (size_t i = 0; i < count; i++) {
+        vertexArrays.push_back(glw::VertexArray::create_unique());
+        vertexArrays.back()->bindVertexBuffer(buffer.get(), {3, 3, 2});
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        vertexArrays[i++ % count]->bind();
+    }
+    glFinish();
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VertexArrayBindChurn)->RangeMultiplier(4)->Range(1, 64);
+
+static void BM_BufferBindBaseChurn(benchmark::State& state) {
+    auto count = static_cast<size_t>(state.range(0));
+
+    std::vector<std::unique_ptr<glw::Buffer>> buffers;
+    for (size_t i = 0; i < count; i++) {
+        buffers.push_back(glw::Buffer::createStorageUnique(256, nullptr, glw::Buffer::StorageFlags::None));
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        buffers[i % count]->bindBase(glw::Buffer::Target::Uniform, i % 8);
+        i++;
+    }
+    glFinish();
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BufferBindBaseChurn)->RangeMultiplier(4)->Range(1, 64);
+
+// Per-draw constants: one shared UBO rewritten with subdata before each bind, versus bump-allocated blocks from the
+// persistently mapped UniformAllocator. Each iteration is one frame of `count` draws' worth of constant updates.
+static constexpr size_t ConstantsSize = 256;
+
+static void BM_UniformSubdataPerDraw(benchmark::State& state) {
+    auto count  = static_cast<size_t>(state.range(0));
+    auto data   = MakeData(ConstantsSize);
+    auto buffer = glw::Buffer::createStorageUnique(ConstantsSize, nullptr, glw::Buffer::StorageFlags::DynamicStorage);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) {
+            buffer->subdata(ConstantsSize, data.data());
+            buffer->bindBase(glw::Buffer::Target::Uniform, 0);
+        }
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_UniformSubdataPerDraw)->RangeMultiplier(8)->Range(8, 4096)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+static void BM_UniformAllocatorPerDraw(benchmark::State& state) {
+    auto                     count = static_cast<size_t>(state.range(0));
+    auto                     data  = MakeData(ConstantsSize);
+    engine::UniformAllocator allocator(count * (ConstantsSize + 256));
+
+    for (auto _ : state) {
+        allocator.beginFrame();
+        for (size_t i = 0; i < count; i++) {
+            allocator.bind(0, allocator.push(data.data(), ConstantsSize));
+        }
+        allocator.endFrame();
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_UniformAllocatorPerDraw)->RangeMultiplier(8)->Range(8, 4096)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// A material switch rebinding `count` uniform ranges and textures: one call per slot versus one multi-bind call per
+// resource class.
+static void BM_MaterialBindPerSlot(benchmark::State& state) {
+    auto   count     = static_cast<unsigned int>(state.range(0));
+    size_t alignment = static_cast<size_t>(glw::GetCapabilities().uniformBufferOffsetAlignment);
+    auto   buffer    = glw::Buffer::createStorageUnique(alignment * count * 2, nullptr, glw::Buffer::StorageFlags::None);
+
+    std::vector<std::unique_ptr<glw::GenericTexture>> textures;
+    for (unsigned int i = 0; i < count * 2; i++) {
+        textures.push_back(std::make_unique<glw::GenericTexture>(glw::GenericTexture::Type::Texture2D));
+        textures.back()->storage2D(1, glw::InternalFormat::RGBA8, 4, 4);
+    }
+
+    size_t material = 0;
+    for (auto _ : state) {
+        size_t base = (material++ & 1) * count;
+        for (unsigned int i = 0; i < count; i++) {
+            buffer->bindRange(glw::Buffer::Target::Uniform, i, {(base + i) * alignment, 16});
+            textures[base + i]->bindUnit(i);
+        }
+    }
+    glFinish();
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MaterialBindPerSlot)->RangeMultiplier(2)->Range(2, 16);
+
+static void BM_MaterialBindBatched(benchmark::State& state) {
+    auto   count     = static_cast<unsigned int>(state.range(0));
+    size_t alignment = static_cast<size_t>(glw::GetCapabilities().uniformBufferOffsetAlignment);
+    auto   buffer    = glw::Buffer::createStorageUnique(alignment * count * 2, nullptr, glw::Buffer::StorageFlags::None);
+
+    std::vector<std::unique_ptr<glw::GenericTexture>> textures;
+    std::vector<const glw::GenericTexture*>           texturePointers;
+    for (unsigned int i = 0; i < count * 2; i++) {
+        textures.push_back(std::make_unique<glw::GenericTexture>(glw::GenericTexture::Type::Texture2D));
+        textures.back()->storage2D(1, glw::InternalFormat::RGBA8, 4, 4);
+        texturePointers.push_back(textures.back().get());
+    }
+
+    std::vector<const glw::Buffer*>    buffers(count, buffer.get());
+    std::vector<engine::range<size_t>> ranges(count * 2);
+    for (unsigned int i = 0; i < count * 2; i++) ranges[i] = {i * alignment, 16};
+
+    size_t material = 0;
+    for (auto _ : state) {
+        size_t base = (material++ & 1) * count;
+        glw::BindBuffersRange(glw::Buffer::Target::Uniform, 0, buffers, std::span(ranges).subspan(base, count));
+        glw::BindTextures(0, std::span(texturePointers).subspan(base, count));
+    }
+    glFinish();
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MaterialBindBatched)->RangeMultiplier(2)->Range(2, 16);
+
+// Compute primitives against their sequential CPU references. Each GPU benchmark checks its output against the
+// reference once before timing; a mismatch skips the benchmark and makes the process exit non-zero. glw_check covers
+// every primitive and value type.
+static bool s_ValidationFailed = false;
+
+static void FailValidation(benchmark::State& state, const char* message) {
+    state.SkipWithError(message);
+    s_ValidationFailed = true;
+}
+
+static void PrimitiveArgs(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(16)->Range(int64_t(1) << 10, int64_t(1) << 20)->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+static std::vector<uint32_t> MakeKeys(size_t count, uint32_t seed) {
+    std::vector<uint32_t> keys(count);
+    for (auto& key : keys) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        key = seed;
+    }
+    return keys;
+}
+
+static std::vector<uint32_t> ReadBack(glw::Buffer& buffer, size_t count) {
+    std::vector<uint32_t> values(count);
+    glGetNamedBufferSubData(buffer.getHandle(), 0, static_cast<GLsizeiptr>(count * sizeof(uint32_t)), values.data());
+    return values;
+}
+
+static std::unique_ptr<glw::Buffer> CreateStorage(size_t count, const void* data = nullptr) {
+    return glw::Buffer::createStorageUnique(std::max<size_t>(count, 1) * sizeof(uint32_t), data, glw::Buffer::StorageFlags::DynamicStorage);
+}
+
+static void BM_ScanGpu(benchmark::State& state) {
+    auto count  = static_cast<uint32_t>(state.range(0));
+    auto values = MakeKeys(count, 1);
+    for (auto& value : values) value &= 0xFF;
+
+    auto                      input  = CreateStorage(count, values.data());
+    auto                      output = CreateStorage(count);
+    engine::ComputePrimitives primitives;
+
+    std::vector<uint32_t> expected(count);
+    engine::reference::ExclusiveScan(values, expected);
+    primitives.exclusiveScan(*input, *output, count);
+    if (ReadBack(*output, count) != expected)
+        FailValidation(state, "GPU scan does not match the reference");
+
+    for (auto _ : state) {
+        primitives.exclusiveScan(*input, *output, count);
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ScanGpu)->Apply(PrimitiveArgs);
+
+static void BM_ScanCpu(benchmark::State& state) {
+    auto                  count  = static_cast<uint32_t>(state.range(0));
+    auto                  values = MakeKeys(count, 1);
+    std::vector<uint32_t> output(count);
+
+    for (auto _ : state) {
+        engine::reference::ExclusiveScan(values, output);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ScanCpu)->Apply(PrimitiveArgs);
+
+static void BM_ReduceGpu(benchmark::State& state) {
+    auto count  = static_cast<uint32_t>(state.range(0));
+    auto values = MakeKeys(count, 2);
+
+    auto                      input  = CreateStorage(count, values.data());
+    auto                      result = CreateStorage(1);
+    engine::ComputePrimitives primitives;
+
+    primitives.reduce(*input, *result, count, engine::ComputePrimitives::ReduceOp::Max);
+    if (ReadBack(*result, 1)[0] != engine::reference::Reduce<uint32_t>(values, engine::ComputePrimitives::ReduceOp::Max))
+        FailValidation(state, "GPU reduction does not match the reference");
+
+    for (auto _ : state) {
+        primitives.reduce(*input, *result, count, engine::ComputePrimitives::ReduceOp::Max);
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ReduceGpu)->Apply(PrimitiveArgs);
+
+static void BM_ReduceCpu(benchmark::State& state) {
+    auto count  = static_cast<uint32_t>(state.range(0));
+    auto values = MakeKeys(count, 2);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine::reference::Reduce<uint32_t>(values, engine::ComputePrimitives::ReduceOp::Max));
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ReduceCpu)->Apply(PrimitiveArgs);
+
+static void BM_CompactGpu(benchmark::State& state) {
+    auto count  = static_cast<uint32_t>(state.range(0));
+    auto values = MakeKeys(count, 3);
+    auto flags  = MakeKeys(count, 4);
+    for (auto& flag : flags) flag &= 1;
+
+    auto                      input       = CreateStorage(count, values.data());
+    auto                      flagsBuffer = CreateStorage(count, flags.data());
+    auto                      output      = CreateStorage(count);
+    auto                      kept        = CreateStorage(1);
+    engine::ComputePrimitives primitives;
+
+    std::vector<uint32_t> expected(count);
+    expected.resize(engine::reference::Compact(values, flags, expected));
+    primitives.compact(*input, *flagsBuffer, *output, *kept, count);
+    if (ReadBack(*kept, 1)[0] != expected.size() || ReadBack(*output, expected.size()) != expected)
+        FailValidation(state, "GPU compaction does not match the reference");
+
+    for (auto _ : state) {
+        primitives.compact(*input, *flagsBuffer, *output, *kept, count);
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CompactGpu)->Apply(PrimitiveArgs);
+
+static void BM_CompactCpu(benchmark::State& state) {
+    auto count  = static_cast<uint32_t>(state.range(0));
+    auto values = MakeKeys(count, 3);
+    auto flags  = MakeKeys(count, 4);
+    for (auto& flag : flags) flag &= 1;
+    std::vector<uint32_t> output(count);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine::reference::Compact(values, flags, output));
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CompactCpu)->Apply(PrimitiveArgs);
+
+static void BM_SortPairsGpu(benchmark::State& state) {
+    auto                  count = static_cast<uint32_t>(state.range(0));
+    auto                  keys  = MakeKeys(count, 5);
+    std::vector<uint32_t> values(count);
+    for (uint32_t i = 0; i < count; i++) values[i] = i;
+
+    auto                      keyBuffer   = CreateStorage(count, keys.data());
+    auto                      valueBuffer = CreateStorage(count, values.data());
+    engine::ComputePrimitives primitives;
+
+    auto expectedKeys   = keys;
+    auto expectedValues = values;
+    engine::reference::SortPairs(expectedKeys, expectedValues);
+    primitives.sortPairs(*keyBuffer, *valueBuffer, count);
+    if (ReadBack(*keyBuffer, count) != expectedKeys || ReadBack(*valueBuffer, count) != expectedValues)
+        FailValidation(state, "GPU sort does not match the reference");
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        keyBuffer->subdata(count * sizeof(uint32_t), keys.data());
+        valueBuffer->subdata(count * sizeof(uint32_t), values.data());
+        glFinish();
+        state.ResumeTiming();
+
+        primitives.sortPairs(*keyBuffer, *valueBuffer, count);
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SortPairsGpu)->Apply(PrimitiveArgs);
+
+static void BM_SortPairsCpu(benchmark::State& state) {
+    auto                  count = static_cast<uint32_t>(state.range(0));
+    auto                  keys  = MakeKeys(count, 5);
+    std::vector<uint32_t> values(count);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sortKeys   = keys;
+        auto sortValues = values;
+        state.ResumeTiming();
+
+        engine::reference::SortPairs(sortKeys, sortValues);
+        benchmark::DoNotOptimize(sortKeys.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SortPairsCpu)->Apply(PrimitiveArgs);
+
+// Clustered light assignment on a 16x9x24 grid, compute path against the SIMD CPU path. The GPU benchmark checks that
+// both produce the same lists before timing.
+static void ClusterArgs(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(4)->Range(256, 16384)->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+static engine::ClusterFrustum MakeClusterFrustum() {
+    engine::ClusterFrustum frustum;
+    frustum.nearPlane   = 0.1f;
+    frustum.farPlane    = 200.0f;
+    frustum.tanHalfFovX = 16.0f / 9.0f;
+    frustum.tanHalfFovY = 1.0f;
+    frustum.width       = 1920;
+    frustum.height      = 1080;
+    return frustum;
+}
+
+// Lights scattered through the view frustum with radii between 0.5 and 8.
+static std::vector<engine::PointLight> MakeLights(size_t count, uint32_t seed) {
+    auto                            random = MakeKeys(count * 4, seed);
+    auto                            unit   = [&](size_t i) { return static_cast<float>(random[i] >> 8) / static_cast<float>(1u << 24); };
+    std::vector<engine::PointLight> lights(count);
+    for (size_t i = 0; i < count; i++) {
+        float depth        = 0.5f + unit(i * 4) * 150.0f;
+        lights[i].position = {(unit(i * 4 + 1) * 2.0f - 1.0f) * depth * 16.0f / 9.0f, (unit(i * 4 + 2) * 2.0f - 1.0f) * depth, -depth};
+        lights[i].radius   = 0.5f + unit(i * 4 + 3) * 7.5f;
+        lights[i].color    = {1.0f, 1.0f, 1.0f};
+    }
+    return lights;
+}
+
+static void BM_ClusterCullGpu(benchmark::State& state) {
+    auto lights = MakeLights(static_cast<size_t>(state.range(0)), 11);
+
+    engine::ClusteredLighting clustered;
+    clustered.setFrustum(MakeClusterFrustum());
+
+    std::vector<engine::ClusterRange> ranges;
+    std::vector<uint32_t>             indices;
+    engine::CullLights(clustered.getBounds(), lights, clustered.getMaxLightsPerCluster(), ranges, indices);
+    clustered.update(lights);
+
+    std::vector<engine::ClusterRange> gpuRanges;
+    std::vector<uint32_t>             gpuIndices;
+    clustered.read(gpuRanges, gpuIndices);
+    bool rangesMatch = std::equal(ranges.begin(), ranges.end(), gpuRanges.begin(), gpuRanges.end(),
+                                  [](const auto& a, const auto& b) { return a.offset == b.offset && a.count == b.count; });
+    if (!rangesMatch || gpuIndices != indices)
+        FailValidation(state, "GPU light lists do not match the CPU path");
+
+    for (auto _ : state) {
+        clustered.update(lights);
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ClusterCullGpu)->Apply(ClusterArgs);
+
+static void BM_ClusterCullCpu(benchmark::State& state) {
+    auto lights = MakeLights(static_cast<size_t>(state.range(0)), 11);
+    auto bounds = engine::BuildClusterBounds({}, MakeClusterFrustum());
+
+    std::vector<engine::ClusterRange> ranges;
+    std::vector<uint32_t>             indices;
+    for (auto _ : state) {
+        engine::CullLights(bounds, lights, 128, ranges, indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ClusterCullCpu)->Apply(ClusterArgs);
+
+int main(int argc, char** argv) {
+    engine::HeadlessContext context;
+    glw::load(engine::HeadlessContext::GetProcAddress);
+
+    const auto& caps = glw::GetCapabilities();
+    benchmark::AddCustomContext("gl_version", caps.version);
+    benchmark::AddCustomContext("gl_renderer", caps.renderer);
+    benchmark::AddCustomContext("gl_vendor", caps.vendor);
+
+    // Default to JSON output next to the binary so runs can be compared against stored baselines.
+    std::vector<char*> args(argv, argv + argc);
+    std::string        out    = "--benchmark_out=glw_bench.json";
+    std::string        format = "--benchmark_out_format=json";
+    bool               hasOut = false;
+    for (int i = 1; i < argc; i++) hasOut |= std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    if (!hasOut) {
+        args.push_back(out.data());
+        args.push_back(format.data());
+    }
+
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+        return EXIT_FAILURE;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return s_ValidationFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
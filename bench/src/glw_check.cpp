@@ -0,0 +1,224 @@
+#include <engine/clustered_lighting.hpp>
+#include <engine/compute_primitives.hpp>
+#include <engine/gl.hpp>
+#include <engine/headless_context.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Runs the GPU compute paths on a headless context and compares them with their CPU references. Registered with
+// CTest; every mismatch is logged and the process exits non-zero if there was any.
+
+using engine::ComputePrimitives;
+
+static int s_Failures = 0;
+
+static void Check(bool passed, const std::string& what) {
+    if (passed)
+        return;
+
+    spdlog::error("Mismatch: {}", what);
+    s_Failures++;
+}
+
+static std::vector<uint32_t> MakeKeys(size_t count, uint32_t seed) {
+    std::vector<uint32_t> keys(count);
+    for (auto& key : keys) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        key = seed;
+    }
+    return keys;
+}
+
+template<typename T>
+static std::unique_ptr<glw::Buffer> CreateStorage(size_t count, const T* data = nullptr) {
+    return glw::Buffer::createStorageUnique(std::max<size_t>(count, 1) * sizeof(T), data, glw::Buffer::StorageFlags::DynamicStorage);
+}
+
+template<typename T>
+static std::vector<T> ReadBack(glw::Buffer& buffer, size_t count) {
+    std::vector<T> values(count);
+    if (count == 0)
+        return values;
+
+    auto memory = buffer.getSubData({0, count * sizeof(T)});
+    std::memcpy(values.data(), memory.data, memory.size);
+    return values;
+}
+
+static void CheckScans(ComputePrimitives& primitives, uint32_t count) {
+    auto values = MakeKeys(count, 1);
+    for (auto& value : values) value &= 0xFF;
+
+    auto                  input  = CreateStorage(count, values.data());
+    auto                  output = CreateStorage<uint32_t>(count);
+    std::vector<uint32_t> expected(count);
+
+    engine::reference::ExclusiveScan(values, expected);
+    primitives.exclusiveScan(*input, *output, count);
+    Check(ReadBack<uint32_t>(*output, count) == expected, fmt::format("exclusive scan of {}", count));
+
+    engine::reference::InclusiveScan(values, expected);
+    primitives.inclusiveScan(*input, *output, count);
+    Check(ReadBack<uint32_t>(*output, count) == expected, fmt::format("inclusive scan of {}", count));
+
+    // In place, as the clustered light culling uses it.
+    engine::reference::ExclusiveScan(values, expected);
+    primitives.exclusiveScan(*input, *input, count);
+    Check(ReadBack<uint32_t>(*input, count) == expected, fmt::format("in-place exclusive scan of {}", count));
+}
+
+template<typename T>
+static void CheckReduce(ComputePrimitives& primitives, const std::vector<T>& values, ComputePrimitives::ValueType type, const char* typeName) {
+    auto count  = static_cast<uint32_t>(values.size());
+    auto input  = CreateStorage(values.size(), values.data());
+    auto result = CreateStorage<T>(1);
+
+    for (auto op : {ComputePrimitives::ReduceOp::Sum, ComputePrimitives::ReduceOp::Min, ComputePrimitives::ReduceOp::Max}) {
+        primitives.reduce(*input, *result, count, op, type);
+        T actual   = ReadBack<T>(*result, 1)[0];
+        T expected = engine::reference::Reduce<T>(values, op);
+
+        // Float sums are associated differently on the GPU.
+        bool passed = actual == expected;
+        if constexpr (std::is_floating_point_v<T>)
+            passed = std::abs(actual - expected) <= 1e-4f * std::max(1.0f, std::abs(expected));
+        Check(passed, fmt::format("{} reduction {} of {}: {} instead of {}", typeName, static_cast<int>(op), count, actual, expected));
+    }
+}
+
+static void CheckReductions(ComputePrimitives& primitives, uint32_t count) {
+    auto keys = MakeKeys(count, 2);
+
+    std::vector<int32_t> ints(count);
+    std::vector<float>   floats(count);
+    for (uint32_t i = 0; i < count; i++) {
+        ints[i]   = static_cast<int32_t>(keys[i]);
+        floats[i] = static_cast<float>(static_cast<int32_t>(keys[i] % 2001) - 1000) * 0.5f;
+    }
+
+    CheckReduce(primitives, keys, ComputePrimitives::ValueType::Uint, "uint");
+    CheckReduce(primitives, ints, ComputePrimitives::ValueType::Int, "int");
+    CheckReduce(primitives, floats, ComputePrimitives::ValueType::Float, "float");
+}
+
+static void CheckCompact(ComputePrimitives& primitives, uint32_t count) {
+    auto values = MakeKeys(count, 3);
+    auto flags  = MakeKeys(count, 4);
+    for (auto& flag : flags) flag = flag % 3 == 0 ? flag : 0;
+
+    auto input       = CreateStorage(count, values.data());
+    auto flagsBuffer = CreateStorage(count, flags.data());
+    auto output      = CreateStorage<uint32_t>(count);
+    auto kept        = CreateStorage<uint32_t>(1);
+    auto arguments   = CreateStorage<uint32_t>(4);
+
+    std::vector<uint32_t> expected(count);
+    expected.resize(engine::reference::Compact(values, flags, expected));
+    primitives.compact(*input, *flagsBuffer, *output, *kept, count);
+    Check(ReadBack<uint32_t>(*kept, 1)[0] == expected.size() && ReadBack<uint32_t>(*output, expected.size()) == expected,
+          fmt::format("compaction of {}", count));
+
+    auto groups = static_cast<uint32_t>((expected.size() + 63) / 64);
+    primitives.writeDispatchArguments(*kept, *arguments, 64, sizeof(uint32_t));
+    Check(ReadBack<uint32_t>(*arguments, 4) == std::vector<uint32_t>{0, groups, 1, 1}, fmt::format("dispatch arguments for {} kept", expected.size()));
+}
+
+static void CheckSort(ComputePrimitives& primitives, uint32_t count) {
+    for (unsigned int keyBits : {32u, 10u, 4u}) {
+        auto                  keys = MakeKeys(count, 5 + keyBits);
+        std::vector<uint32_t> values(count);
+        for (uint32_t i = 0; i < count; i++) values[i] = i;
+
+        auto keyBuffer   = CreateStorage(count, keys.data());
+        auto valueBuffer = CreateStorage(count, values.data());
+
+        engine::reference::SortPairs(keys, values, keyBits);
+        primitives.sortPairs(*keyBuffer, *valueBuffer, count, keyBits);
+        Check(ReadBack<uint32_t>(*keyBuffer, count) == keys && ReadBack<uint32_t>(*valueBuffer, count) == values,
+              fmt::format("{}-bit sort of {}", keyBits, count));
+    }
+}
+
+// Lights scattered through the view frustum with radii between 0.5 and 8.
+static std::vector<engine::PointLight> MakeLights(size_t count, uint32_t seed) {
+    auto                            random = MakeKeys(count * 4, seed);
+    auto                            unit   = [&](size_t i) { return static_cast<float>(random[i] >> 8) / static_cast<float>(1u << 24); };
+    std::vector<engine::PointLight> lights(count);
+    for (size_t i = 0; i < count; i++) {
+        float depth        = 0.5f + unit(i * 4) * 150.0f;
+        lights[i].position = {(unit(i * 4 + 1) * 2.0f - 1.0f) * depth * 16.0f / 9.0f, (unit(i * 4 + 2) * 2.0f - 1.0f) * depth, -depth};
+        lights[i].radius   = 0.5f + unit(i * 4 + 3) * 7.5f;
+        lights[i].color    = {1.0f, 1.0f, 1.0f};
+    }
+    return lights;
+}
+
+// Both backends must produce exactly the lists CullLights does.
+static void CheckClusterCulling(uint32_t lightCount, uint32_t maxLightsPerCluster) {
+    engine::ClusterFrustum frustum;
+    frustum.farPlane    = 200.0f;
+    frustum.tanHalfFovX = 16.0f / 9.0f;
+    frustum.width       = 1920;
+    frustum.height      = 1080;
+
+    auto lights = MakeLights(lightCount, 11 + lightCount);
+    for (auto backend : {engine::ClusteredLighting::Backend::Compute, engine::ClusteredLighting::Backend::Cpu}) {
+        engine::ClusteredLighting clustered({}, maxLightsPerCluster, backend);
+        clustered.setFrustum(frustum);
+        clustered.update(lights);
+
+        std::vector<engine::ClusterRange> expectedRanges, ranges;
+        std::vector<uint32_t>             expectedIndices, indices;
+        engine::CullLights(clustered.getBounds(), lights, maxLightsPerCluster, expectedRanges, expectedIndices);
+        clustered.read(ranges, indices);
+
+        bool rangesMatch = std::equal(ranges.begin(), ranges.end(), expectedRanges.begin(), expectedRanges.end(),
+                                      [](const auto& a, const auto& b) { return a.offset == b.offset && a.count == b.count; });
+        Check(rangesMatch && indices == expectedIndices, fmt::format("{} cluster lists for {} lights, at most {} per cluster",
+                                                                     backend == engine::ClusteredLighting::Backend::Compute ? "compute" : "CPU", lightCount,
+                                                                     maxLightsPerCluster));
+    }
+}
+
+int main() {
+    try {
+        engine::HeadlessContext context;
+        glw::load(engine::HeadlessContext::GetProcAddress);
+
+        // Sizes around the block sizes, and past one and two levels of block sums.
+        ComputePrimitives primitives;
+        for (uint32_t count : {1u, 3u, 1000u, 1024u, 1025u, 300000u, (1u << 20) + 5u}) {
+            CheckScans(primitives, count);
+            CheckReductions(primitives, count);
+            CheckCompact(primitives, count);
+            CheckSort(primitives, count);
+        }
+
+        for (uint32_t lightCount : {0u, 1u, 100u, 1000u, 4096u}) {
+            CheckClusterCulling(lightCount, 128);
+            CheckClusterCulling(lightCount, 8);
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Check failed: {}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (s_Failures > 0) {
+        spdlog::error("{} check(s) failed", s_Failures);
+        return EXIT_FAILURE;
+    }
+
+    spdlog::info("All checks passed");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+#include <engine/gl.hpp>
+#include <engine/gpu_profiler.hpp>
+#include <engine/headless_context.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Replays a glw capture on a headless context and reports per-frame timings in the flat JSON format perf_compare
+// understands. Every frame ends with glFinish() so CPU times include the driver's work on the replayed stream.
+
+struct Options {
+    std::string trace;
+    std::string output = "glw_replay.json";
+    int         repeat = 1;
+    int         warmup = 1;
+};
+
+struct Percentiles {
+    double p50 = 0.0, p95 = 0.0, p99 = 0.0, mean = 0.0, max = 0.0;
+};
+
+static Percentiles ComputePercentiles(std::vector<double> samples) {
+    Percentiles p;
+    if (samples.empty())
+        return p;
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[std::min(samples.size() - 1, static_cast<size_t>(q * static_cast<double>(samples.size())))]; };
+    p.p50   = at(0.50);
+    p.p95   = at(0.95);
+    p.p99   = at(0.99);
+    p.max   = samples.back();
+    for (double s : samples) p.mean += s;
+    p.mean /= static_cast<double>(samples.size());
+    return p;
+}
+
+static nlohmann::json ToJson(const Percentiles& p) {
+    return {{"p50", p.p50}, {"p95", p.p95}, {"p99", p.p99}, {"mean", p.mean}, {"max", p.max}};
+}
+
+static constexpr const char* Usage = "Usage: glw_replay <trace> [--repeat=1] [--warmup=1] [--output=glw_replay.json]\n";
+
+// Accepts an integer of at least `minimum` that spans the whole argument.
+static bool ParseCount(std::string_view arg, std::string_view prefix, int minimum, int& target) {
+    std::string_view text = arg.substr(prefix.size());
+    int              value;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size() || value < minimum) {
+        std::cerr << "Invalid value in '" << arg << "'\n" << Usage;
+        return false;
+    }
+    target = value;
+    return true;
+}
+
+static bool ParseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--output="))
+            options.output = arg.substr(9);
+        else if (arg.starts_with("--repeat=")) {
+            if (!ParseCount(arg, "--repeat=", 1, options.repeat))
+                return false;
+        } else if (arg.starts_with("--warmup=")) {
+            if (!ParseCount(arg, "--warmup=", 0, options.warmup))
+                return false;
+        } else if (!arg.starts_with("--") && options.trace.empty())
+            options.trace = arg;
+        else {
+            std::cerr << "Unknown argument '" << arg << "'\n" << Usage;
+            return false;
+        }
+    }
+
+    if (options.trace.empty()) {
+        std::cerr << Usage;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseArguments(argc, argv, options))
+        return 2;
+
+    try {
+        // Inside the try so a missing EGL device is reported like any other failure; destroyed after the replayer.
+        engine::HeadlessContext context;
+        glw::load(engine::HeadlessContext::GetProcAddress);
+
+        glw::CaptureReplayer replayer(options.trace);
+        spdlog::info("Replaying '{}': {} commands, {} frames, captured on {} ({})", options.trace, replayer.getCommandCount(), replayer.getFrameCount(),
+                     replayer.getRenderer(), replayer.getVersion());
+
+        engine::GpuProfiler profiler;
+        std::vector<double> cpuFrameTimes;
+        std::vector<double> gpuFrameTimes;
+        uint64_t            lastResolved = 0;
+
+        // Warmup passes let the driver settle shader compiles and allocations before anything is measured.
+        for (int pass = 0; pass < options.warmup + options.repeat; pass++) {
+            bool measured = pass >= options.warmup;
+            replayer.rewind();
+
+            for (;;) {
+                auto start = std::chrono::steady_clock::now();
+                profiler.beginFrame();
+                bool more = replayer.replayFrame();
+                profiler.endFrame();
+                glFinish();
+                auto end = std::chrono::steady_clock::now();
+
+                if (!more)
+                    break;
+
+                if (measured)
+                    cpuFrameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+                // GPU results arrive a few frames late; every newly resolved frame counts once.
+                if (measured && profiler.getLastFrameNumber() != lastResolved && !profiler.getLastFrame().empty())
+                    gpuFrameTimes.push_back(profiler.getLastFrame().front().durationMilliseconds);
+                lastResolved = profiler.getLastFrameNumber();
+            }
+        }
+
+        auto cpu = ComputePercentiles(cpuFrameTimes);
+        auto gpu = ComputePercentiles(gpuFrameTimes);
+
+        const auto&    caps   = glw::GetCapabilities();
+        nlohmann::json result = {
+            {"renderer", caps.renderer},
+            {"version", caps.version},
+            {"settings",
+             {{"trace", options.trace},
+              {"frames", replayer.getFrameCount()},
+              {"commands", replayer.getCommandCount()},
+              {"repeat", options.repeat},
+              {"warmup", options.warmup}}},
+            {"measured_frames", cpuFrameTimes.size()},
+            {"cpu_frame_ms", ToJson(cpu)},
+            {"gpu_frame_ms", ToJson(gpu)},
+        };
+
+        std::ofstream file(options.output);
+        if (!file) {
+            spdlog::error("Failed to write replay results to '{}'", options.output);
+            return EXIT_FAILURE;
+        }
+        file << result.dump(4) << '\n';
+
+        spdlog::info("CPU frame: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms", cpu.p50, cpu.p95, cpu.p99);
+        spdlog::info("GPU frame: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms", gpu.p50, gpu.p95, gpu.p99);
+        spdlog::info("Results written to '{}'", options.output);
+    } catch (const std::exception& e) {
+        spdlog::error("Replay failed: {}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,267 @@
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compares benchmark JSON results against stored baselines. Understands Google Benchmark output (glw_bench, one
+// sample per repetition) and the example's --benchmark output (one sample per run). Every file passed counts as
+// additional runs, so repeated invocations raise confidence. All metrics are "lower is better".
+
+struct Metric {
+    std::vector<double> baseline;
+    std::vector<double> current;
+    std::string         error; // Set when a current run reported an error, e.g. a failed validation
+};
+
+struct Options {
+    std::vector<std::string> baselines;
+    std::vector<std::string> currents;
+    double                   threshold = 0.05;
+    double                   alpha     = 0.05;
+    std::string              report;
+};
+
+static double ToNanoseconds(double value, const std::string& unit) {
+    if (unit == "us")
+        return value * 1e3;
+    if (unit == "ms")
+        return value * 1e6;
+    if (unit == "s")
+        return value * 1e9;
+    return value;
+}
+
+static void CollectGoogleBenchmark(const nlohmann::json& document, std::map<std::string, Metric>& metrics, bool baseline) {
+    for (const auto& entry : document["benchmarks"]) {
+        if (entry.value("run_type", "iteration") != "iteration")
+            continue;
+
+        auto name = entry.value("run_name", entry.value("name", std::string()));
+        if (entry.value("error_occurred", false)) {
+            if (!baseline)
+                metrics[name + " [ns]"].error = entry.value("error_message", std::string("unknown error"));
+            continue;
+        }
+
+        auto  value  = ToNanoseconds(entry.value("real_time", 0.0), entry.value("time_unit", std::string("ns")));
+        auto& metric = metrics[name + " [ns]"];
+        (baseline ? metric.baseline : metric.current).push_back(value);
+    }
+}
+
+static void CollectFlat(const nlohmann::json& value, const std::string& prefix, std::map<std::string, Metric>& metrics, bool baseline) {
+    for (const auto& [key, child] : value.items()) {
+        if (key == "settings")
+            continue;
+
+        std::string name = prefix.empty() ? key : prefix + "." + key;
+        if (child.is_object())
+            CollectFlat(child, name, metrics, baseline);
+        else if (child.is_number() && name != "measured_frames") {
+            auto& metric = metrics[name];
+            (baseline ? metric.baseline : metric.current).push_back(child.get<double>());
+        }
+    }
+}
+
+static bool Collect(const std::string& path, std::map<std::string, Metric>& metrics, bool baseline) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open '" << path << "'\n";
+        return false;
+    }
+
+    nlohmann::json document;
+    try {
+        file >> document;
+    } catch (const nlohmann::json::exception& e) {
+        std::cerr << "Failed to parse '" << path << "': " << e.what() << '\n';
+        return false;
+    }
+
+    if (document.contains("benchmarks"))
+        CollectGoogleBenchmark(document, metrics, baseline);
+    else
+        CollectFlat(document, "", metrics, baseline);
+    return true;
+}
+
+static double Mean(const std::vector<double>& v) {
+    return std::accumulate(v.begin(), v.end(), 0.0) / static_cast<double>(v.size());
+}
+
+static double Variance(const std::vector<double>& v, double mean) {
+    double sum = 0.0;
+    for (double x : v) sum += (x - mean) * (x - mean);
+    return sum / static_cast<double>(v.size() - 1);
+}
+
+// Continued fraction for the regularized incomplete beta function (Lentz's method).
+static double BetaContinuedFraction(double a, double b, double x) {
+    constexpr double Tiny = 1e-300;
+    double           c = 1.0, d = 1.0 - (a + b) * x / (a + 1.0);
+    d          = 1.0 / (std::abs(d) < Tiny ? Tiny : d);
+    double h   = d;
+    for (int m = 1; m <= 200; m++) {
+        double m2 = 2.0 * m;
+        double aa = m * (b - m) * x / ((a + m2 - 1.0) * (a + m2));
+        d         = 1.0 / (std::abs(1.0 + aa * d) < Tiny ? Tiny : 1.0 + aa * d);
+        c         = std::abs(1.0 + aa / c) < Tiny ? Tiny : 1.0 + aa / c;
+        h *= d * c;
+
+        aa      = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1.0));
+        d       = 1.0 / (std::abs(1.0 + aa * d) < Tiny ? Tiny : 1.0 + aa * d);
+        c       = std::abs(1.0 + aa / c) < Tiny ? Tiny : 1.0 + aa / c;
+        double del = d * c;
+        h *= del;
+        if (std::abs(del - 1.0) < 1e-12)
+            break;
+    }
+    return h;
+}
+
+static double RegularizedBeta(double a, double b, double x) {
+    if (x <= 0.0)
+        return 0.0;
+    if (x >= 1.0)
+        return 1.0;
+
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0))
+        return front * BetaContinuedFraction(a, b, x) / a;
+    return 1.0 - front * BetaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+// Two-sided p-value of Welch's t-test; 1.0 when there are not enough samples to estimate variance.
+static double WelchPValue(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() < 2 || b.size() < 2)
+        return 1.0;
+
+    double ma = Mean(a), mb = Mean(b);
+    double va = Variance(a, ma) / static_cast<double>(a.size());
+    double vb = Variance(b, mb) / static_cast<double>(b.size());
+    if (va + vb == 0.0)
+        return ma == mb ? 1.0 : 0.0;
+
+    double t  = (ma - mb) / std::sqrt(va + vb);
+    double df = (va + vb) * (va + vb) / (va * va / static_cast<double>(a.size() - 1) + vb * vb / static_cast<double>(b.size() - 1));
+    return RegularizedBeta(df / 2.0, 0.5, df / (df + t * t));
+}
+
+static constexpr const char* Usage = "Usage: perf_compare --baseline=<json>... --current=<json>... [--threshold=0.05] [--alpha=0.05] [--report=<json>]\n";
+
+// Accepts a finite, non-negative number that spans the whole argument.
+static bool ParseNumber(std::string_view arg, std::string_view prefix, double& target) {
+    std::string_view text = arg.substr(prefix.size());
+    double           value;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size() || !std::isfinite(value) || value < 0.0) {
+        std::cerr << "Invalid value in '" << arg << "'\n" << Usage;
+        return false;
+    }
+    target = value;
+    return true;
+}
+
+static bool ParseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--baseline="))
+            options.baselines.emplace_back(arg.substr(11));
+        else if (arg.starts_with("--current="))
+            options.currents.emplace_back(arg.substr(10));
+        else if (arg.starts_with("--threshold=")) {
+            if (!ParseNumber(arg, "--threshold=", options.threshold))
+                return false;
+        } else if (arg.starts_with("--alpha=")) {
+            if (!ParseNumber(arg, "--alpha=", options.alpha))
+                return false;
+        } else if (arg.starts_with("--report="))
+            options.report = arg.substr(9);
+        else {
+            std::cerr << "Unknown argument '" << arg << "'\n" << Usage;
+            return false;
+        }
+    }
+
+    if (options.baselines.empty() || options.currents.empty()) {
+        std::cerr << Usage;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseArguments(argc, argv, options))
+        return 2;
+
+    std::map<std::string, Metric> metrics;
+    for (const auto& path : options.baselines) {
+        if (!Collect(path, metrics, true))
+            return 2;
+    }
+    for (const auto& path : options.currents) {
+        if (!Collect(path, metrics, false))
+            return 2;
+    }
+
+    nlohmann::json report = nlohmann::json::array();
+    int            regressions = 0, improvements = 0, errors = 0;
+
+    std::printf("%-64s %14s %14s %9s %8s  %s\n", "Metric", "Baseline", "Current", "Change", "p", "Verdict");
+    for (const auto& [name, metric] : metrics) {
+        if (!metric.error.empty()) {
+            errors++;
+            std::printf("%-64s %14s %14s %9s %8s  ERROR: %s\n", name.c_str(), "-", "-", "-", "-", metric.error.c_str());
+            report.push_back({{"metric", name}, {"verdict", "error"}, {"error", metric.error}});
+            continue;
+        }
+
+        if (metric.baseline.empty() || metric.current.empty())
+            continue;
+
+        double baseline = Mean(metric.baseline);
+        double current  = Mean(metric.current);
+        double change   = baseline == 0.0 ? (current == 0.0 ? 0.0 : INFINITY) : current / baseline - 1.0;
+        double p        = WelchPValue(metric.baseline, metric.current);
+
+        // With repeated runs a change must be both larger than the noise threshold and statistically significant;
+        // single runs fall back to the threshold alone.
+        bool        repeated    = metric.baseline.size() >= 2 && metric.current.size() >= 2;
+        bool        significant = std::abs(change) > options.threshold && (!repeated || p < options.alpha);
+        std::string verdict     = !significant ? "ok" : change > 0.0 ? "REGRESSION" : "improved";
+        if (significant)
+            (change > 0.0 ? regressions : improvements)++;
+
+        std::printf("%-64s %14.4g %14.4g %+8.2f%% %8.4f  %s\n", name.c_str(), baseline, current, change * 100.0, p, verdict.c_str());
+        report.push_back({{"metric", name},
+                          {"baseline", baseline},
+                          {"current", current},
+                          {"baseline_samples", metric.baseline.size()},
+                          {"current_samples", metric.current.size()},
+                          {"change", change},
+                          {"p_value", p},
+                          {"verdict", verdict}});
+    }
+
+    std::printf("\n%d regression(s), %d improvement(s) beyond %.1f%% noise threshold, %d error(s)\n", regressions, improvements, options.threshold * 100.0,
+                errors);
+
+    if (!options.report.empty()) {
+        std::ofstream file(options.report);
+        file << report.dump(4) << '\n';
+    }
+
+    return regressions > 0 || errors > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,390 @@
+#include "benchmark.hpp"
+
+#include <engine/gl.hpp>
+#include <engine/gl_pipeline.hpp>
+#include <engine/gl_sampler.hpp>
+#include <engine/gpu_profiler.hpp>
+#include <engine/transparency.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <string_view>
+
+namespace example {
+    static const char* VertexShaderSource = R"(#version 450 core
+layout(location = 0) in vec3 a_Position;
+
+layout(std140, binding = 0) uniform Camera {
+    mat4 u_ViewProjection;
+};
+
+layout(std140, binding = 1) uniform Object {
+    mat4 u_Model;
+};
+
+out vec2 v_UV;
+
+void main() {
+    v_UV        = a_Position.xy * 0.5 + 0.5;
+    gl_Position = u_ViewProjection * u_Model * vec4(a_Position, 1.0);
+}
+)";
+
+    static const char* FragmentShaderSource = R"(#version 450 core
+layout(std140, binding = 2) uniform Material {
+    vec4 u_Tint;
+};
+
+layout(binding = 0) uniform sampler2D u_Albedo;
+
+in vec2 v_UV;
+out vec4 o_Color;
+
+void main() {
+    vec4 color = texture(u_Albedo, v_UV) * u_Tint;
+#if VARIANT == 1
+    color.rgb = color.bgr;
+#elif VARIANT == 2
+    color.rgb = vec3(dot(color.rgb, vec3(0.299, 0.587, 0.114)));
+#elif VARIANT == 3
+    color.rgb = pow(color.rgb, vec3(1.0 / 2.2));
+#endif
+#ifdef OIT
+    oitInsert(color);
+#else
+    o_Color = color;
+#endif
+}
+)";
+
+    static constexpr int ProgramVariants = 4;
+    static constexpr int TextureSize     = 64;
+
+    struct Percentiles {
+        double mean = 0.0;
+        double min  = 0.0;
+        double max  = 0.0;
+        double p50  = 0.0;
+        double p95  = 0.0;
+        double p99  = 0.0;
+    };
+
+    static Percentiles ComputePercentiles(std::vector<double> samples) {
+        Percentiles p;
+        if (samples.empty())
+            return p;
+
+        std::sort(samples.begin(), samples.end());
+        auto at = [&](double q) { return samples[std::min(samples.size() - 1, static_cast<size_t>(std::ceil(q * samples.size())) - 1)]; };
+
+        p.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+        p.min  = samples.front();
+        p.max  = samples.back();
+        p.p50  = at(0.50);
+        p.p95  = at(0.95);
+        p.p99  = at(0.99);
+        return p;
+    }
+
+    static nlohmann::json ToJson(const Percentiles& p) {
+        return {{"mean", p.mean}, {"min", p.min}, {"max", p.max}, {"p50", p.p50}, {"p95", p.p95}, {"p99", p.p99}};
+    }
+
+    static size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Stores the integer following `prefix`, raised to at least `minimum`; malformed values leave `target` unchanged.
+    static void ParseCount(std::string_view arg, std::string_view prefix, int minimum, int& target) {
+        std::string_view text  = arg.substr(prefix.size());
+        int              value = 0;
+        auto [end, error]      = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc{} || end != text.data() + text.size() || text.empty()) {
+            spdlog::warn("Ignoring malformed argument '{}'", arg);
+            return;
+        }
+        target = std::max(value, minimum);
+    }
+
+    std::optional<BenchmarkSettings> ParseBenchmarkArguments(int argc, char** argv) {
+        BenchmarkSettings settings;
+        bool              enabled = false;
+
+        for (int i = 1; i < argc; i++) {
+            std::string_view arg   = argv[i];
+            auto             value = [&](std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg == "--benchmark")
+                enabled = true;
+            else if (arg == "--sort")
+                settings.sortByMaterial = true;
+            else if (arg == "--oit")
+                settings.transparency = true;
+            else if (arg.starts_with("--frames="))
+                ParseCount(arg, "--frames=", 1, settings.frames);
+            else if (arg.starts_with("--warmup="))
+                ParseCount(arg, "--warmup=", 0, settings.warmupFrames);
+            else if (arg.starts_with("--meshes="))
+                ParseCount(arg, "--meshes=", 0, settings.meshes);
+            else if (arg.starts_with("--materials="))
+                ParseCount(arg, "--materials=", 1, settings.materials);
+            else if (arg.starts_with("--textures="))
+                ParseCount(arg, "--textures=", 1, settings.textures);
+            else if (arg.starts_with("--dynamic="))
+                ParseCount(arg, "--dynamic=", 0, settings.dynamicMeshes);
+            else if (arg.starts_with("--output="))
+                settings.output = value("--output=");
+            else if (arg.starts_with("--capture="))
+                settings.capture = value("--capture=");
+            else
+                spdlog::warn("Ignoring unknown argument '{}'", arg);
+        }
+
+        if (!enabled)
+            return std::nullopt;
+        return settings;
+    }
+
+    int RunBenchmark(GLFWwindow* window, const BenchmarkSettings& settings) {
+        const auto& caps = glw::GetCapabilities();
+        glfwSwapInterval(0);
+
+        if (!settings.capture.empty())
+            glw::BeginCapture(settings.capture);
+
+        // Variant 3 blends so that pipeline switches carry a fixed-function delta as well as a program change. With
+        // --oit it is transparent instead: fragments go to per-pixel lists that are composited after the scene.
+        std::vector<std::shared_ptr<glw::Program>>  programs;
+        std::vector<std::shared_ptr<glw::Pipeline>> pipelines;
+        for (int v = 0; v < ProgramVariants; v++) {
+            bool        transparent = settings.transparency && v == 3;
+            std::string fragment    = FragmentShaderSource;
+            std::string defines     = "#define VARIANT " + std::to_string(v) + "\n";
+            if (transparent)
+                defines += "#define OIT\n" + engine::OrderIndependentTransparency::getShaderInterface();
+            fragment.insert(fragment.find('\n') + 1, defines);
+            programs.push_back(glw::Program::create({{glw::Shader::Type::Vertex, VertexShaderSource}, {glw::Shader::Type::Fragment, fragment}}));
+
+            glw::PipelineState state;
+            state.blend.enabled        = v == 3 && !transparent;
+            state.blend.srcColor       = glw::BlendFactor::SrcAlpha;
+            state.blend.dstColor       = glw::BlendFactor::OneMinusSrcAlpha;
+            state.blend.colorWriteMask = transparent ? 0 : 0xF;
+            pipelines.push_back(glw::Pipeline::create({programs.back(), state}));
+        }
+
+        std::unique_ptr<engine::OrderIndependentTransparency> transparency;
+        if (settings.transparency) {
+            int width = 0, height = 0;
+            glfwGetFramebufferSize(window, &width, &height);
+            transparency = std::make_unique<engine::OrderIndependentTransparency>(width, height);
+        }
+
+        glw::StateCache stateCache;
+
+        // All variants share one interface, so bindings are resolved once here rather than per draw.
+        const auto&  reflection      = programs.front()->getReflection();
+        unsigned int cameraBinding   = reflection.getBinding("Camera");
+        unsigned int objectBinding   = reflection.getBinding("Object");
+        unsigned int materialBinding = reflection.getBinding("Material");
+        unsigned int albedoUnit      = reflection.getBinding("u_Albedo");
+
+        // Two meshes (quad and triangle) share one vertex/index buffer.
+        std::vector<float>    vertices = {-1, -1, 0, 1, -1, 0, 1, 1, 0, -1, 1, 0, -1, -1, 0, 1, -1, 0, 0, 1, 0};
+        std::vector<uint32_t> indices  = {0, 1, 2, 2, 3, 0, 4, 5, 6};
+        auto                  vertexBuffer = glw::Buffer::create(vertices, glw::Buffer::Usage::StaticDraw);
+        auto                  indexBuffer  = glw::Buffer::create(indices, glw::Buffer::Usage::StaticDraw);
+        auto                  vertexArray  = glw::VertexArray::create();
+        vertexBuffer->setMemoryTag(glw::MemoryTag::Mesh);
+        indexBuffer->setMemoryTag(glw::MemoryTag::Mesh);
+        vertexArray->bindVertexBuffer(vertexBuffer, {3});
+        vertexArray->bindElementBuffer(indexBuffer);
+
+        glw::SamplerCache samplers;
+        const auto*       albedoSampler = samplers.get({.minFilter = glw::Sampler::Filter::Linear, .magFilter = glw::Sampler::Filter::Linear});
+
+        std::vector<std::unique_ptr<glw::GenericTexture>> textures;
+        std::vector<uint32_t>                             pixels(TextureSize * TextureSize);
+        for (int t = 0; t < settings.textures; t++) {
+            auto texture = std::make_unique<glw::GenericTexture>(glw::GenericTexture::Type::Texture2D);
+            for (int i = 0; i < TextureSize * TextureSize; i++) {
+                pixels[i] = ((i / TextureSize + i % TextureSize + t) & 8) ? 0xFFFFFFFF : 0xFF000000 | (t * 0x102030);
+            }
+            texture->storage2D(1, glw::InternalFormat::RGBA8, TextureSize, TextureSize);
+            glTextureSubImage2D(texture->getHandle(), 0, 0, 0, TextureSize, TextureSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            textures.push_back(std::move(texture));
+        }
+
+        size_t alignment      = static_cast<size_t>(caps.uniformBufferOffsetAlignment);
+        size_t objectStride   = AlignUp(sizeof(glm::mat4), alignment);
+        size_t materialStride = AlignUp(sizeof(glm::vec4), alignment);
+
+        std::vector<uint8_t> materialData(materialStride * settings.materials);
+        for (int m = 0; m < settings.materials; m++) {
+            glm::vec4 tint(0.5f + 0.5f * static_cast<float>(m % 3) / 2.0f, 0.5f + 0.5f * static_cast<float>(m % 5) / 4.0f, 1.0f, 1.0f);
+            std::memcpy(materialData.data() + m * materialStride, &tint, sizeof(tint));
+        }
+        auto materialBuffer = glw::Buffer::create(materialData, glw::Buffer::Usage::StaticDraw);
+        materialBuffer->setMemoryTag(glw::MemoryTag::Uniform);
+
+        int                  grid = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(settings.meshes)))));
+        float                cell = 2.0f / static_cast<float>(grid);
+        std::vector<uint8_t> objectData(objectStride * std::max(1, settings.meshes));
+        auto                 writeObject = [&](int i, float time) {
+            glm::mat4 model(cell * 0.4f);
+            model[3] = glm::vec4(-1.0f + cell * (static_cast<float>(i % grid) + 0.5f + 0.1f * std::sin(time + static_cast<float>(i))),
+                                 -1.0f + cell * (static_cast<float>(i / grid) + 0.5f), 0.0f, 1.0f);
+            std::memcpy(objectData.data() + i * objectStride, &model, sizeof(model));
+        };
+        for (int i = 0; i < settings.meshes; i++) writeObject(i, 0.0f);
+        auto objectBuffer = glw::Buffer::create(objectData, glw::Buffer::Usage::DynamicDraw);
+        objectBuffer->setMemoryTag(glw::MemoryTag::Uniform);
+
+        glw::ResetFrameStats();
+
+        glm::mat4 viewProjection(1.0f);
+        auto      cameraBuffer = glw::Buffer::create(sizeof(viewProjection), &viewProjection, glw::Buffer::Usage::StaticDraw);
+        cameraBuffer->bindBase(glw::Buffer::Target::Uniform, cameraBinding);
+
+        std::vector<int> drawOrder(settings.meshes);
+        std::iota(drawOrder.begin(), drawOrder.end(), 0);
+        if (settings.sortByMaterial)
+            std::stable_sort(drawOrder.begin(), drawOrder.end(), [&](int a, int b) { return a % settings.materials < b % settings.materials; });
+
+        engine::GpuProfiler profiler;
+
+        std::vector<double> cpuFrameTimes;
+        std::vector<double> gpuFrameTimes;
+        cpuFrameTimes.reserve(settings.frames);
+        gpuFrameTimes.reserve(settings.frames);
+
+        glw::FrameStats totals;
+        uint64_t        lastResolved = UINT64_MAX;
+
+        auto previous = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < settings.warmupFrames + settings.frames && !glfwWindowShouldClose(window); frame++) {
+            bool measured = frame >= settings.warmupFrames;
+            glfwPollEvents();
+
+            profiler.beginFrame();
+            if (measured && profiler.getLastFrameNumber() != lastResolved && !profiler.getLastFrame().empty()) {
+                lastResolved = profiler.getLastFrameNumber();
+                if (lastResolved >= static_cast<uint64_t>(settings.warmupFrames))
+                    gpuFrameTimes.push_back(profiler.getLastFrame().front().durationMilliseconds);
+            }
+
+            {
+                ENGINE_GPU_SCOPE(profiler, "Dynamic updates");
+                float time = static_cast<float>(frame) * 0.016f;
+                for (int d = 0; d < settings.dynamicMeshes && d < settings.meshes; d++) {
+                    int i = (frame * settings.dynamicMeshes + d) % settings.meshes;
+                    writeObject(i, time);
+                    objectBuffer->subdata(sizeof(glm::mat4), objectData.data() + i * objectStride, i * objectStride);
+                }
+            }
+
+            {
+                ENGINE_GPU_SCOPE(profiler, "Scene");
+                glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+                if (transparency)
+                    transparency->begin();
+                vertexArray->bind();
+                stateCache.bindSamplers(albedoUnit, {albedoSampler});
+
+                int currentMaterial = -1, currentProgram = -1, currentTexture = -1;
+                for (int i : drawOrder) {
+                    int material = i % settings.materials;
+                    int program  = material % ProgramVariants;
+                    int texture  = material % settings.textures;
+
+                    if (program != currentProgram) {
+                        stateCache.bind(pipelines[program]);
+                        currentProgram = program;
+                    }
+                    if (texture != currentTexture) {
+                        textures[texture]->bindUnit(albedoUnit);
+                        currentTexture = texture;
+                    }
+                    if (material != currentMaterial) {
+                        materialBuffer->bindRange(glw::Buffer::Target::Uniform, materialBinding, {material * materialStride, sizeof(glm::vec4)});
+                        currentMaterial = material;
+                    }
+
+                    objectBuffer->bindRange(glw::Buffer::Target::Uniform, objectBinding, {i * objectStride, sizeof(glm::mat4)});
+
+                    bool quad = (i & 1) == 0;
+                    glw::DrawElements(GL_TRIANGLES, quad ? 6 : 3, GL_UNSIGNED_INT, quad ? 0 : 6 * sizeof(uint32_t));
+                }
+            }
+
+            if (transparency) {
+                ENGINE_GPU_SCOPE(profiler, "Transparency resolve");
+                transparency->resolve(stateCache);
+            }
+
+            profiler.endFrame();
+            glfwSwapBuffers(window);
+
+            glw::ResetFrameStats();
+            auto now = std::chrono::steady_clock::now();
+            if (measured) {
+                cpuFrameTimes.push_back(std::chrono::duration<double, std::milli>(now - previous).count());
+                for (const auto& [name, field] : glw::FrameStatsFields) totals.*field += glw::GetLastFrameStats().*field;
+            }
+            previous = now;
+        }
+
+        glFinish();
+        glw::EndCapture();
+        profiler.beginFrame();
+        profiler.endFrame();
+        if (profiler.getLastFrameNumber() != lastResolved && !profiler.getLastFrame().empty())
+            gpuFrameTimes.push_back(profiler.getLastFrame().front().durationMilliseconds);
+
+        double frames = static_cast<double>(std::max<size_t>(1, cpuFrameTimes.size()));
+        auto   cpu    = ComputePercentiles(cpuFrameTimes);
+        auto   gpu    = ComputePercentiles(gpuFrameTimes);
+
+        nlohmann::json perFrame;
+        for (const auto& [name, field] : glw::FrameStatsFields) perFrame[name] = static_cast<double>(totals.*field) / frames;
+
+        nlohmann::json result = {
+            {"renderer", caps.renderer},
+            {"version", caps.version},
+            {"settings",
+             {{"frames", settings.frames},
+              {"warmup_frames", settings.warmupFrames},
+              {"meshes", settings.meshes},
+              {"materials", settings.materials},
+              {"textures", settings.textures},
+              {"dynamic_meshes", settings.dynamicMeshes},
+              {"sort_by_material", settings.sortByMaterial},
+              {"order_independent_transparency", settings.transparency}}},
+            {"measured_frames", cpuFrameTimes.size()},
+            {"cpu_frame_ms", ToJson(cpu)},
+            {"gpu_frame_ms", ToJson(gpu)},
+            {"per_frame", perFrame},
+            {"gpu_memory_peak_bytes", glw::GetTotalMemoryUsage().highWater},
+        };
+
+        std::ofstream file(settings.output);
+        if (!file) {
+            spdlog::error("Failed to write benchmark results to '{}'", settings.output);
+            return EXIT_FAILURE;
+        }
+        file << result.dump(4) << '\n';
+
+        spdlog::info("CPU frame: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms", cpu.p50, cpu.p95, cpu.p99);
+        spdlog::info("GPU frame: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms", gpu.p50, gpu.p95, gpu.p99);
+        glw::LogMemoryUsage();
+        spdlog::info("Results written to '{}'", settings.output);
+        return EXIT_SUCCESS;
+    }
+} // namespace example
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <engine/engine.hpp>
+
+#include <optional>
+#include <string>
+
+namespace example {
+    struct BenchmarkSettings {
+        int         frames         = 600;
+        int         warmupFrames   = 60;
+        int         meshes         = 2000;
+        int         materials      = 32;
+        int         textures       = 16;
+        int         dynamicMeshes  = 200;
+        bool        sortByMaterial = false;
+        bool        transparency   = false;
+        std::string output         = "example_benchmark.json";
+        std::string capture;
+    };
+
+    // Returns settings when --benchmark is present. Recognised options: --frames=N --warmup=N --meshes=N
+    // --materials=N --textures=N --dynamic=N --sort --oit --output=path --capture=trace
+    std::optional<BenchmarkSettings> ParseBenchmarkArguments(int argc, char** argv);
+
+    int RunBenchmark(GLFWwindow* window, const BenchmarkSettings& settings);
+} // namespace example
@@ -1,9 +1,12 @@
 #include <engine/engine.hpp>
 #include <engine/gl.hpp>
+#include <engine/gl_debug.hpp>
+
+#include "benchmark.hpp"
 
 #include <iostream>
 
-int main() {
+int main(int argc, char** argv) {
     glfwInit();
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -12,29 +15,35 @@ int main() {
 //    glfwWindowHint(GLFW_MAXIMIZED, true);
     glfwWindowHint(GLFW_SCALE_TO_MONITOR, false);
     glfwWindowHint(GLFW_SCALE_FRAMEBUFFER, false);
+#ifndef NDEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
+#endif
 
     GLFWwindow* window = glfwCreateWindow(800, 600, "Hello!", nullptr, nullptr);
     glfwMakeContextCurrent(window);
 
     glw::load();
+    glw::EnableDebugOutput();
+
+    const auto& caps = glw::GetCapabilities();
 
-    auto exts = glw::GetExtensions();
+    const auto& exts = glw::GetExtensions();
     std::cout << "Extensions (" << exts.size() << ")\n";
     for (const auto& s : exts) {
         std::cout << "- " << s << '\n';
     }
     std::cout << '\n';
 
-    auto spv_exts = glw::GetSpirVExtensions();
+    const auto& spv_exts = glw::GetSpirVExtensions();
     std::cout << "SPIR-V Extensions (" << spv_exts.size() << ")\n";
     for (const auto& s : spv_exts) {
         std::cout << "- " << s << '\n';
     }
 
-    auto gl_ver = glw::GetString(GL_VERSION);
-    auto gl_vendor = glw::GetString(GL_VENDOR);
-    auto gl_renderer = glw::GetString(GL_RENDERER);
-    auto glsl_version = glw::GetString(GL_SHADING_LANGUAGE_VERSION);
+    const auto& gl_ver = caps.version;
+    const auto& gl_vendor = caps.vendor;
+    const auto& gl_renderer = caps.renderer;
+    const auto& glsl_version = caps.shadingLanguageVersion;
 
     std::cout << "=======================================================================================================================\n";
     std::cout << "GL Info:\n";
@@ -45,6 +54,13 @@ int main() {
     std::cout << "=======================================================================================================================\n";
 
 
+    if (auto settings = example::ParseBenchmarkArguments(argc, argv)) {
+        int result = example::RunBenchmark(window, *settings);
+        glw::DisableDebugOutput();
+        glfwTerminate();
+        return result;
+    }
+
     std::vector<float> verts = {0,0,0,1,0,0,0,1,0};
     auto vertex_buffer = glw::Buffer::create(verts, glw::Buffer::Usage::StaticDraw);
     auto vertex_array = glw::VertexArray::create();
@@ -64,6 +80,7 @@ int main() {
         glfwSwapBuffers(window);
     }
 
+    glw::DisableDebugOutput();
     glfwTerminate();
 
     return EXIT_SUCCESS;
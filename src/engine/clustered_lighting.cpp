@@ -0,0 +1,350 @@
+#include "engine/clustered_lighting.hpp"
+#include "engine/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_CLUSTER_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace engine {
+    // Lights, bounds and ranges go to the GPU as they are.
+    static_assert(sizeof(PointLight) == glw::Std430<PointLight>::Size && glw::Std430<PointLight>::Offsets == std::array<size_t, 4>{0, 12, 16, 28});
+    static_assert(sizeof(ClusterBounds) == glw::Std430<ClusterBounds>::Size && sizeof(ClusterRange) == glw::Std430<ClusterRange>::Size);
+
+    namespace {
+        // One invocation per cluster. The workgroup stages lights in shared memory a batch at a time and every
+        // invocation tests its froxel against the whole batch. The distance test is `precise` so that it rounds exactly
+        // like CullLights. WRITE_LISTS selects the second pass, which stores the lights at the scanned offsets.
+        constexpr const char* CullSource = R"(
+layout(local_size_x = {0}) in;
+
+struct ClusterLight {{
+    vec3  position;
+    float radius;
+    vec3  color;
+    float intensity;
+}};
+
+struct ClusterBounds {{
+    vec4 minimum;
+    vec4 maximum;
+}};
+
+layout(std430, binding = 0) readonly buffer Bounds {{ ClusterBounds u_Bounds[]; }};
+layout(std430, binding = 1) readonly buffer Lights {{ ClusterLight u_Lights[]; }};
+#ifdef WRITE_LISTS
+layout(std430, binding = 2) readonly buffer Offsets {{ uint u_Offsets[]; }};
+layout(std430, binding = 3) writeonly buffer Ranges {{ uvec2 u_Ranges[]; }};
+layout(std430, binding = 4) writeonly buffer Indices {{ uint u_Indices[]; }};
+#else
+layout(std430, binding = 2) writeonly buffer Offsets {{ uint u_Offsets[]; }};
+#endif
+
+layout(location = 0) uniform uint u_ClusterCount;
+layout(location = 1) uniform uint u_LightCount;
+layout(location = 2) uniform uint u_MaxLightsPerCluster;
+
+shared vec4 s_Lights[{0}];
+
+void main() {{
+    uint cluster = gl_GlobalInvocationID.x;
+    bool valid   = cluster < u_ClusterCount;
+    vec3 minimum = valid ? u_Bounds[cluster].minimum.xyz : vec3(0.0);
+    vec3 maximum = valid ? u_Bounds[cluster].maximum.xyz : vec3(0.0);
+#ifdef WRITE_LISTS
+    uint offset = valid ? u_Offsets[cluster] : 0u;
+#endif
+
+    uint count = 0u;
+    for (uint base = 0u; base < u_LightCount; base += {0}u) {{
+        uint light = base + gl_LocalInvocationID.x;
+        s_Lights[gl_LocalInvocationID.x] = light < u_LightCount ? vec4(u_Lights[light].position, u_Lights[light].radius) : vec4(0.0);
+        barrier();
+
+        uint batch = min({0}u, u_LightCount - base);
+        for (uint i = 0u; i < batch; i++) {{
+            vec4          sphere          = s_Lights[i];
+            precise vec3  outside         = max(max(minimum - sphere.xyz, 0.0), sphere.xyz - maximum);
+            precise float distanceSquared = outside.x * outside.x + outside.y * outside.y + outside.z * outside.z;
+            precise float radiusSquared   = sphere.w * sphere.w;
+            if (valid && distanceSquared <= radiusSquared && count < u_MaxLightsPerCluster) {{
+#ifdef WRITE_LISTS
+                u_Indices[offset + count] = base + i;
+#endif
+                count++;
+            }}
+        }}
+        barrier();
+    }}
+
+    if (valid) {{
+#ifdef WRITE_LISTS
+        u_Ranges[cluster] = uvec2(offset, count);
+#else
+        u_Offsets[cluster] = count;
+#endif
+    }}
+}}
+)";
+
+        constexpr const char* ShaderInterfaceSource = R"(
+struct ClusterLight {{
+    vec3  position;
+    float radius;
+    vec3  color;
+    float intensity;
+}};
+
+layout(std140, binding = {0}) uniform ClusterGrid {{
+    uvec4 u_ClusterGrid;  // Cluster counts along x, y and z
+    vec4  u_ClusterScale; // Pixels to tiles (xy), log(depth) to slice scale and bias (zw)
+}};
+
+layout(std430, binding = {1}) readonly buffer ClusterLights {{ ClusterLight u_ClusterLights[]; }};
+layout(std430, binding = {2}) readonly buffer ClusterRanges {{ uvec2 u_ClusterRanges[]; }};
+layout(std430, binding = {3}) readonly buffer ClusterLightIndices {{ uint u_ClusterLightIndices[]; }};
+
+uvec2 clusterLightRange(vec2 fragCoord, float viewZ) {{
+    uvec2 tile  = min(uvec2(max(fragCoord * u_ClusterScale.xy, vec2(0.0))), u_ClusterGrid.xy - 1u);
+    float slice = log(max(-viewZ, 1e-6)) * u_ClusterScale.z + u_ClusterScale.w;
+    uint  z     = uint(clamp(slice, 0.0, float(u_ClusterGrid.z - 1u)));
+    return u_ClusterRanges[tile.x + u_ClusterGrid.x * (tile.y + u_ClusterGrid.y * z)];
+}}
+)";
+
+        // std140 block ClusterGrid.
+        struct GridParameters {
+            uint32_t grid[4];
+            float    scale[4];
+        };
+
+        constexpr auto Storage = glw::Buffer::Target::ShaderStorage;
+
+        std::unique_ptr<glw::Buffer> CreateStorage(size_t size) {
+            return glw::Buffer::createStorageUnique(std::bit_ceil(std::max<size_t>(size, 256)), nullptr, glw::Buffer::StorageFlags::DynamicStorage);
+        }
+
+        std::shared_ptr<glw::ComputePipeline> CreateCullPipeline(bool writeLists) {
+            using Access = glw::ComputePipeline::Access;
+
+            std::string source = "#version 450\n";
+            if (writeLists)
+                source += "#define WRITE_LISTS\n";
+            source += fmt::format(CullSource, ClusteredLighting::CullGroupSize);
+
+            auto program = glw::Program::create({{glw::Shader::Type::Compute, source}});
+            if (!program->isLinked())
+                throw std::runtime_error("Failed to build light culling program: " + program->getInfoLog());
+
+            if (writeLists)
+                return glw::ComputePipeline::create(
+                        {program, {{"Bounds", Access::Read}, {"Lights", Access::Read}, {"Offsets", Access::Read}, {"Ranges", Access::Write}, {"Indices", Access::Write}}});
+            return glw::ComputePipeline::create({program, {{"Bounds", Access::Read}, {"Lights", Access::Read}, {"Offsets", Access::Write}}});
+        }
+    } // namespace
+
+    ClusteredLighting::ClusteredLighting(ClusterGrid grid, uint32_t maxLightsPerCluster, Backend backend)
+        : m_Grid(grid), m_MaxLightsPerCluster(maxLightsPerCluster), m_Backend(backend) {
+        if (grid.x == 0 || grid.y == 0 || grid.z == 0)
+            throw std::runtime_error("Cluster grid must have at least one cluster along every axis");
+
+        uint32_t clusters = m_Grid.getClusterCount();
+        m_GridParameters  = glw::Buffer::createStorageUnique(sizeof(GridParameters), nullptr, glw::Buffer::StorageFlags::DynamicStorage);
+        m_ClusterBounds   = CreateStorage(clusters * sizeof(ClusterBounds));
+        m_Offsets         = CreateStorage(clusters * sizeof(uint32_t));
+        m_Ranges          = CreateStorage(clusters * sizeof(ClusterRange));
+        m_Lights          = CreateStorage(0);
+        m_Indices         = CreateStorage(0);
+
+        if (m_Backend == Backend::Compute) {
+            m_CountPipeline = CreateCullPipeline(false);
+            m_WritePipeline = CreateCullPipeline(true);
+            m_Primitives    = std::make_unique<ComputePrimitives>();
+        }
+
+        setFrustum(m_Frustum);
+    }
+
+    void ClusteredLighting::setFrustum(const ClusterFrustum& frustum) {
+        if (!(frustum.nearPlane > 0.0f && frustum.farPlane > frustum.nearPlane))
+            throw std::runtime_error(fmt::format("Invalid cluster depth range [{}, {}]", frustum.nearPlane, frustum.farPlane));
+
+        m_Frustum = frustum;
+        m_Bounds  = BuildClusterBounds(m_Grid, m_Frustum);
+        m_ClusterBounds->subdata(m_Bounds);
+
+        float logRatio = std::log(frustum.farPlane / frustum.nearPlane);
+
+        GridParameters parameters{};
+        parameters.grid[0]  = m_Grid.x;
+        parameters.grid[1]  = m_Grid.y;
+        parameters.grid[2]  = m_Grid.z;
+        parameters.scale[0] = static_cast<float>(m_Grid.x) / static_cast<float>(std::max(frustum.width, 1));
+        parameters.scale[1] = static_cast<float>(m_Grid.y) / static_cast<float>(std::max(frustum.height, 1));
+        parameters.scale[2] = static_cast<float>(m_Grid.z) / logRatio;
+        parameters.scale[3] = -static_cast<float>(m_Grid.z) * std::log(frustum.nearPlane) / logRatio;
+        m_GridParameters->subdata(sizeof(parameters), &parameters);
+    }
+
+    void ClusteredLighting::update(std::span<const PointLight> lights) {
+        ENGINE_PROFILE_FUNCTION();
+
+        m_LightCount = static_cast<uint32_t>(lights.size());
+        if (m_Lights->getCurrentSize() < lights.size_bytes())
+            m_Lights = CreateStorage(lights.size_bytes());
+        if (!lights.empty())
+            m_Lights->subdata(lights.size_bytes(), lights.data());
+
+        // Enough for every cluster to fill up; the lists themselves stay compact.
+        size_t indexCapacity = static_cast<size_t>(m_Grid.getClusterCount()) * std::min(m_MaxLightsPerCluster, m_LightCount) * sizeof(uint32_t);
+        if (m_Indices->getCurrentSize() < indexCapacity)
+            m_Indices = CreateStorage(indexCapacity);
+
+        if (m_Backend == Backend::Compute)
+            cullCompute();
+        else
+            cullCpu(lights);
+    }
+
+    void ClusteredLighting::cullCompute() {
+        uint32_t                          clusters = m_Grid.getClusterCount();
+        std::array<const glw::Buffer*, 5> buffers  = {m_ClusterBounds.get(), m_Lights.get(), m_Offsets.get(), m_Ranges.get(), m_Indices.get()};
+
+        for (const auto* pipeline : {m_CountPipeline.get(), m_WritePipeline.get()}) {
+            const auto& program = *pipeline->getProgram();
+            program.setUniform(0, clusters);
+            program.setUniform(1, m_LightCount);
+            program.setUniform(2, m_MaxLightsPerCluster);
+        }
+
+        glw::BindBuffersBase(Storage, 0, buffers);
+        m_CountPipeline->dispatchThreads(clusters);
+        m_Primitives->exclusiveScan(*m_Offsets, *m_Offsets, clusters);
+
+        // The scan binds its own buffers.
+        glw::BindBuffersBase(Storage, 0, buffers);
+        m_WritePipeline->dispatchThreads(clusters);
+    }
+
+    void ClusteredLighting::cullCpu(std::span<const PointLight> lights) {
+        CullLights(m_Bounds, lights, m_MaxLightsPerCluster, m_CpuRanges, m_CpuIndices);
+        m_Ranges->subdata(m_CpuRanges);
+        if (!m_CpuIndices.empty())
+            m_Indices->subdata(m_CpuIndices);
+    }
+
+    void ClusteredLighting::bind() const {
+        glw::InsertPendingBarriers(glw::BarrierBit::ShaderStorage);
+
+        std::array<const glw::Buffer*, 3> buffers = {m_Lights.get(), m_Ranges.get(), m_Indices.get()};
+        m_GridParameters->bindBase(glw::Buffer::Target::Uniform, GridBinding);
+        glw::BindBuffersBase(Storage, LightBinding, buffers);
+    }
+
+    void ClusteredLighting::read(std::vector<ClusterRange>& ranges, std::vector<uint32_t>& indices) const {
+        ranges.resize(m_Grid.getClusterCount());
+        auto rangeData = m_Ranges->getSubData({0, ranges.size() * sizeof(ClusterRange)});
+        std::memcpy(ranges.data(), rangeData.data, rangeData.size);
+
+        indices.resize(ranges.empty() ? 0 : ranges.back().offset + ranges.back().count);
+        if (indices.empty())
+            return;
+
+        auto indexData = m_Indices->getSubData({0, indices.size() * sizeof(uint32_t)});
+        std::memcpy(indices.data(), indexData.data, indexData.size);
+    }
+
+    std::string ClusteredLighting::getShaderInterface() {
+        return fmt::format(ShaderInterfaceSource, GridBinding, LightBinding, RangeBinding, IndexBinding);
+    }
+
+    std::vector<ClusterBounds> BuildClusterBounds(const ClusterGrid& grid, const ClusterFrustum& frustum) {
+        std::vector<ClusterBounds> bounds;
+        bounds.reserve(grid.getClusterCount());
+
+        float ratio = frustum.farPlane / frustum.nearPlane;
+        auto  edge  = [](uint32_t i, uint32_t count, float tanHalfFov) { return (2.0f * static_cast<float>(i) / static_cast<float>(count) - 1.0f) * tanHalfFov; };
+
+        for (uint32_t z = 0; z < grid.z; z++) {
+            float nearDepth = frustum.nearPlane * std::pow(ratio, static_cast<float>(z) / static_cast<float>(grid.z));
+            float farDepth  = frustum.nearPlane * std::pow(ratio, static_cast<float>(z + 1) / static_cast<float>(grid.z));
+
+            for (uint32_t y = 0; y < grid.y; y++) {
+                float bottom = edge(y, grid.y, frustum.tanHalfFovY);
+                float top    = edge(y + 1, grid.y, frustum.tanHalfFovY);
+
+                // A tile widens with depth, so each side's extreme lies on the near or the far plane of the slice.
+                for (uint32_t x = 0; x < grid.x; x++) {
+                    float left  = edge(x, grid.x, frustum.tanHalfFovX);
+                    float right = edge(x + 1, grid.x, frustum.tanHalfFovX);
+                    bounds.push_back({{std::min(left * nearDepth, left * farDepth), std::min(bottom * nearDepth, bottom * farDepth), -farDepth, 0.0f},
+                                      {std::max(right * nearDepth, right * farDepth), std::max(top * nearDepth, top * farDepth), -nearDepth, 0.0f}});
+                }
+            }
+        }
+        return bounds;
+    }
+
+    void CullLights(std::span<const ClusterBounds> clusters, std::span<const PointLight> lights, uint32_t maxLightsPerCluster, std::vector<ClusterRange>& ranges,
+                    std::vector<uint32_t>& indices) {
+        ENGINE_PROFILE_FUNCTION();
+
+        ranges.assign(clusters.size(), {});
+        indices.clear();
+
+        // Structure of arrays padded to whole SIMD steps. Padding has a negative squared radius and never passes.
+        size_t             padded = (lights.size() + 3) / 4 * 4;
+        std::vector<float> x(padded, 0.0f), y(padded, 0.0f), z(padded, 0.0f), radiusSquared(padded, -1.0f);
+        for (size_t i = 0; i < lights.size(); i++) {
+            x[i]             = lights[i].position.x;
+            y[i]             = lights[i].position.y;
+            z[i]             = lights[i].position.z;
+            radiusSquared[i] = lights[i].radius * lights[i].radius;
+        }
+
+        for (size_t c = 0; c < clusters.size(); c++) {
+            const auto& bounds = clusters[c];
+            auto        offset = static_cast<uint32_t>(indices.size());
+            uint32_t    count  = 0;
+
+#ifdef ENGINE_CLUSTER_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 minX = _mm_set1_ps(bounds.minimum.x), minY = _mm_set1_ps(bounds.minimum.y), minZ = _mm_set1_ps(bounds.minimum.z);
+            const __m128 maxX = _mm_set1_ps(bounds.maximum.x), maxY = _mm_set1_ps(bounds.maximum.y), maxZ = _mm_set1_ps(bounds.maximum.z);
+
+            for (size_t i = 0; i < padded && count < maxLightsPerCluster; i += 4) {
+                __m128 px = _mm_loadu_ps(&x[i]), py = _mm_loadu_ps(&y[i]), pz = _mm_loadu_ps(&z[i]);
+                __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, px), zero), _mm_sub_ps(px, maxX));
+                __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, py), zero), _mm_sub_ps(py, maxY));
+                __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, pz), zero), _mm_sub_ps(pz, maxZ));
+                __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+                auto hits = static_cast<unsigned int>(_mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_loadu_ps(&radiusSquared[i]))));
+                for (; hits != 0 && count < maxLightsPerCluster; hits &= hits - 1, count++)
+                    indices.push_back(static_cast<uint32_t>(i) + static_cast<uint32_t>(std::countr_zero(hits)));
+            }
+#else
+            // Built with -ffp-contract=off, so the sum rounds like the GPU's precise one rather than as FMAs.
+            for (size_t i = 0; i < lights.size() && count < maxLightsPerCluster; i++) {
+                float dx = std::max(std::max(bounds.minimum.x - x[i], 0.0f), x[i] - bounds.maximum.x);
+                float dy = std::max(std::max(bounds.minimum.y - y[i], 0.0f), y[i] - bounds.maximum.y);
+                float dz = std::max(std::max(bounds.minimum.z - z[i], 0.0f), z[i] - bounds.maximum.z);
+                if (dx * dx + dy * dy + dz * dz <= radiusSquared[i]) {
+                    indices.push_back(static_cast<uint32_t>(i));
+                    count++;
+                }
+            }
+#endif
+
+            ranges[c] = {offset, count};
+        }
+    }
+
+} // namespace engine
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "engine/compute_primitives.hpp"
+#include "engine/gl.hpp"
+#include "engine/gl_compute.hpp"
+#include "engine/std_layout.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace engine {
+
+    // View-space point light; the camera looks down -Z. Matches the std430 layout of ClusterLight in the shaders.
+    struct PointLight {
+        glm::vec3 position;
+        float     radius = 1.0f;
+        glm::vec3 color;
+        float     intensity = 1.0f;
+    };
+
+    // Axis-aligned view-space bounds of one froxel; w is unused.
+    struct ClusterBounds {
+        glm::vec4 minimum;
+        glm::vec4 maximum;
+    };
+
+    // A cluster's slice of the light index list.
+    struct ClusterRange {
+        uint32_t offset = 0;
+        uint32_t count  = 0;
+    };
+
+    struct ClusterGrid {
+        uint32_t x = 16;
+        uint32_t y = 9;
+        uint32_t z = 24;
+
+        [[nodiscard]] inline uint32_t getClusterCount() const noexcept { return x * y * z; };
+    };
+
+    // Symmetric perspective camera and the framebuffer it renders to.
+    struct ClusterFrustum {
+        float nearPlane   = 0.1f;
+        float farPlane    = 1000.0f;
+        float tanHalfFovX = 1.0f;
+        float tanHalfFovY = 1.0f;
+        int   width       = 1;
+        int   height      = 1;
+    };
+
+    // Clustered forward lighting. The view frustum is split into a grid of froxels - screen tiles times depth slices
+    // spaced exponentially between the near and far planes - and every update() assigns the lights to the froxels
+    // their spheres touch: a compute pass counts the lights per cluster, an exclusive scan turns the counts into
+    // offsets and a second pass writes the compact index lists. Shading passes then loop only over the lights of the
+    // fragment's cluster (see getShaderInterface()).
+    //
+    // A cluster keeps at most `maxLightsPerCluster` lights, the lowest-indexed ones. The lists are deterministic, so
+    // Backend::Cpu (CullLights) produces exactly the same buffers and can stand in for, or validate, the compute path.
+    class ClusteredLighting {
+      public:
+        enum class Backend {
+            Compute,
+            Cpu,
+        };
+
+        static constexpr unsigned int GridBinding   = 3; // Uniform block
+        static constexpr unsigned int LightBinding  = 3; // Shader storage blocks
+        static constexpr unsigned int RangeBinding  = 4;
+        static constexpr unsigned int IndexBinding  = 5;
+        static constexpr uint32_t     CullGroupSize = 64;
+
+        explicit ClusteredLighting(ClusterGrid grid = {}, uint32_t maxLightsPerCluster = 128, Backend backend = Backend::Compute);
+
+        ClusteredLighting(const ClusteredLighting&)            = delete;
+        ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+        // Rebuilds the froxel bounds; only needed when the projection or framebuffer size changes.
+        void setFrustum(const ClusterFrustum& frustum);
+
+        // Uploads the lights and rebuilds every cluster's light list.
+        void update(std::span<const PointLight> lights);
+
+        // Binds the grid, lights and lists for shading, after synchronizing with the culling passes.
+        void bind() const;
+
+        // Copies the light lists back in CullLights' layout, after synchronizing with the culling passes. Stalls on
+        // the GPU; meant for validation and tools.
+        void read(std::vector<ClusterRange>& ranges, std::vector<uint32_t>& indices) const;
+
+        // GLSL to paste into shading programs after the #version line. Declares the ClusterLight struct, the
+        // u_ClusterLights and u_ClusterLightIndices arrays and `uvec2 clusterLightRange(vec2 fragCoord, float viewZ)`,
+        // which returns the offset and count of the fragment's lights in u_ClusterLightIndices.
+        [[nodiscard]] static std::string getShaderInterface();
+
+        [[nodiscard]] inline const ClusterGrid& getGrid() const noexcept { return m_Grid; };
+        [[nodiscard]] inline const ClusterFrustum& getFrustum() const noexcept { return m_Frustum; };
+        [[nodiscard]] inline const std::vector<ClusterBounds>& getBounds() const noexcept { return m_Bounds; };
+        [[nodiscard]] inline uint32_t getMaxLightsPerCluster() const noexcept { return m_MaxLightsPerCluster; };
+        [[nodiscard]] inline uint32_t getLightCount() const noexcept { return m_LightCount; };
+        [[nodiscard]] inline Backend getBackend() const noexcept { return m_Backend; };
+
+        // ClusterRange per cluster, indexed x + grid.x * (y + grid.y * z), and the index list they point into.
+        [[nodiscard]] inline glw::Buffer& getRanges() const noexcept { return *m_Ranges; };
+        [[nodiscard]] inline glw::Buffer& getIndices() const noexcept { return *m_Indices; };
+
+      private:
+        void cullCompute();
+        void cullCpu(std::span<const PointLight> lights);
+
+        ClusterGrid                m_Grid;
+        ClusterFrustum             m_Frustum;
+        uint32_t                   m_MaxLightsPerCluster = 0;
+        uint32_t                   m_LightCount          = 0;
+        Backend                    m_Backend             = Backend::Compute;
+        std::vector<ClusterBounds> m_Bounds;
+
+        std::unique_ptr<glw::Buffer>          m_GridParameters;
+        std::unique_ptr<glw::Buffer>          m_ClusterBounds;
+        std::unique_ptr<glw::Buffer>          m_Lights;
+        std::unique_ptr<glw::Buffer>          m_Offsets;
+        std::unique_ptr<glw::Buffer>          m_Ranges;
+        std::unique_ptr<glw::Buffer>          m_Indices;
+        std::shared_ptr<glw::ComputePipeline> m_CountPipeline;
+        std::shared_ptr<glw::ComputePipeline> m_WritePipeline;
+        std::unique_ptr<ComputePrimitives>    m_Primitives;
+
+        std::vector<ClusterRange> m_CpuRanges;
+        std::vector<uint32_t>     m_CpuIndices;
+    };
+
+    // Froxel bounds in cluster order for `grid` over `frustum`.
+    [[nodiscard]] std::vector<ClusterBounds> BuildClusterBounds(const ClusterGrid& grid, const ClusterFrustum& frustum);
+
+    // CPU light assignment with the same results as the compute path. Lights are tested four at a time with SSE where
+    // available. Replaces the contents of `ranges` and `indices`.
+    void CullLights(std::span<const ClusterBounds> clusters, std::span<const PointLight> lights, uint32_t maxLightsPerCluster, std::vector<ClusterRange>& ranges,
+                    std::vector<uint32_t>& indices);
+
+} // namespace engine
+
+GLW_STD_LAYOUT(engine::PointLight, &engine::PointLight::position, &engine::PointLight::radius, &engine::PointLight::color, &engine::PointLight::intensity);
+GLW_STD_LAYOUT(engine::ClusterBounds, &engine::ClusterBounds::minimum, &engine::ClusterBounds::maximum);
+GLW_STD_LAYOUT(engine::ClusterRange, &engine::ClusterRange::offset, &engine::ClusterRange::count);
@@ -0,0 +1,557 @@
+#include "engine/compute_primitives.hpp"
+#include "engine/profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <initializer_list>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace engine {
+    namespace {
+        // Each invocation scans four consecutive elements, then the workgroup scans the per-invocation totals in shared
+        // memory. Flags: 1 = inclusive, 2 = write the block total to BlockSums, 4 = treat non-zero inputs as 1.
+        constexpr const char* ScanLocalSource = R"(
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) readonly buffer Input { uint u_Input[]; };
+layout(std430, binding = 1) writeonly buffer Output { uint u_Output[]; };
+layout(std430, binding = 2) writeonly buffer BlockSums { uint u_BlockSums[]; };
+
+layout(location = 0) uniform uint u_Count;
+layout(location = 1) uniform uint u_Flags;
+
+shared uint s_Sums[256];
+
+void main() {
+    uint local = gl_LocalInvocationID.x;
+    uint base  = gl_WorkGroupID.x * 1024u + local * 4u;
+
+    uint values[4];
+    uint total = 0u;
+    for (uint i = 0u; i < 4u; i++) {
+        uint value = base + i < u_Count ? u_Input[base + i] : 0u;
+        if ((u_Flags & 4u) != 0u)
+            value = value != 0u ? 1u : 0u;
+        values[i] = value;
+        total += value;
+    }
+
+    s_Sums[local] = total;
+    barrier();
+    for (uint offset = 1u; offset < 256u; offset <<= 1u) {
+        uint other = local >= offset ? s_Sums[local - offset] : 0u;
+        barrier();
+        s_Sums[local] += other;
+        barrier();
+    }
+
+    bool inclusive = (u_Flags & 1u) != 0u;
+    uint running   = s_Sums[local] - total;
+    for (uint i = 0u; i < 4u; i++) {
+        if (inclusive)
+            running += values[i];
+        if (base + i < u_Count)
+            u_Output[base + i] = running;
+        if (!inclusive)
+            running += values[i];
+    }
+
+    if (local == 255u && (u_Flags & 2u) != 0u)
+        u_BlockSums[gl_WorkGroupID.x] = s_Sums[255];
+}
+)";
+
+        constexpr const char* ScanAddSource = R"(
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 1) buffer Output { uint u_Output[]; };
+layout(std430, binding = 2) readonly buffer BlockSums { uint u_BlockSums[]; };
+
+layout(location = 0) uniform uint u_Count;
+
+void main() {
+    uint base = gl_WorkGroupID.x * 1024u + gl_LocalInvocationID.x * 4u;
+    uint add  = u_BlockSums[gl_WorkGroupID.x];
+    for (uint i = 0u; i < 4u; i++)
+        if (base + i < u_Count)
+            u_Output[base + i] += add;
+}
+)";
+
+        constexpr const char* CompactScatterSource = R"(
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) readonly buffer Input { uint u_Input[]; };
+layout(std430, binding = 1) readonly buffer Flags { uint u_Flags[]; };
+layout(std430, binding = 2) readonly buffer Indices { uint u_Indices[]; };
+layout(std430, binding = 3) writeonly buffer Output { uint u_Output[]; };
+layout(std430, binding = 4) writeonly buffer KeptCount { uint u_KeptCount; };
+
+layout(location = 0) uniform uint u_Count;
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= u_Count)
+        return;
+
+    bool keep = u_Flags[i] != 0u;
+    if (keep)
+        u_Output[u_Indices[i]] = u_Input[i];
+    if (i == u_Count - 1u)
+        u_KeptCount = u_Indices[i] + (keep ? 1u : 0u);
+}
+)";
+
+        // Digit-major layout (digit * blocks + block), so one exclusive scan yields every block's scatter base. Blocks
+        // are 1024 keys, four per invocation.
+        constexpr const char* SortHistogramSource = R"(
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) readonly buffer Keys { uint u_Keys[]; };
+layout(std430, binding = 4) writeonly buffer Histogram { uint u_Histogram[]; };
+
+layout(location = 0) uniform uint u_Count;
+layout(location = 1) uniform uint u_Shift;
+
+shared uint s_Counts[16];
+
+void main() {
+    uint local = gl_LocalInvocationID.x;
+    if (local < 16u)
+        s_Counts[local] = 0u;
+    barrier();
+
+    uint base = gl_WorkGroupID.x * 1024u + local * 4u;
+    for (uint i = 0u; i < 4u; i++)
+        if (base + i < u_Count)
+            atomicAdd(s_Counts[(u_Keys[base + i] >> u_Shift) & 15u], 1u);
+    barrier();
+
+    if (local < 16u)
+        u_Histogram[local * gl_NumWorkGroups.x + gl_WorkGroupID.x] = s_Counts[local];
+}
+)";
+
+        // Ranks each key among earlier keys of the same digit in its block. The 16 digit counters are packed two per
+        // uint (a block holds 1024 keys) into two uvec4s, counted serially over an invocation's four keys and then
+        // scanned across the workgroup.
+        constexpr const char* SortScatterSource = R"(
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) readonly buffer KeysIn { uint u_KeysIn[]; };
+layout(std430, binding = 1) readonly buffer ValuesIn { uint u_ValuesIn[]; };
+layout(std430, binding = 2) writeonly buffer KeysOut { uint u_KeysOut[]; };
+layout(std430, binding = 3) writeonly buffer ValuesOut { uint u_ValuesOut[]; };
+layout(std430, binding = 4) readonly buffer Offsets { uint u_Offsets[]; };
+
+layout(location = 0) uniform uint u_Count;
+layout(location = 1) uniform uint u_Shift;
+
+shared uvec4 s_Ranks[2][256];
+
+uint countOf(uvec4 low, uvec4 high, uint digit) {
+    uvec4 counts = digit < 8u ? low : high;
+    return (counts[(digit >> 1u) & 3u] >> ((digit & 1u) * 16u)) & 0xFFFFu;
+}
+
+void main() {
+    uint local = gl_LocalInvocationID.x;
+    uint base  = gl_WorkGroupID.x * 1024u + local * 4u;
+
+    uint  keys[4];
+    uint  ranks[4];
+    uvec4 low  = uvec4(0u);
+    uvec4 high = uvec4(0u);
+    for (uint i = 0u; i < 4u; i++) {
+        keys[i] = base + i < u_Count ? u_KeysIn[base + i] : 0u;
+        if (base + i >= u_Count)
+            continue;
+
+        uint  digit = (keys[i] >> u_Shift) & 15u;
+        uvec4 one   = uvec4(equal(uvec4((digit >> 1u) & 3u), uvec4(0u, 1u, 2u, 3u))) << ((digit & 1u) * 16u);
+        ranks[i]    = countOf(low, high, digit);
+        if (digit < 8u)
+            low += one;
+        else
+            high += one;
+    }
+
+    uvec4 ownLow  = low;
+    uvec4 ownHigh = high;
+    s_Ranks[0][local] = low;
+    s_Ranks[1][local] = high;
+    barrier();
+
+    for (uint offset = 1u; offset < 256u; offset <<= 1u) {
+        if (local >= offset) {
+            low += s_Ranks[0][local - offset];
+            high += s_Ranks[1][local - offset];
+        }
+        barrier();
+        s_Ranks[0][local] = low;
+        s_Ranks[1][local] = high;
+        barrier();
+    }
+
+    // Exclusive prefix of earlier invocations.
+    low -= ownLow;
+    high -= ownHigh;
+
+    for (uint i = 0u; i < 4u; i++) {
+        if (base + i >= u_Count)
+            return;
+
+        uint digit       = (keys[i] >> u_Shift) & 15u;
+        uint destination = u_Offsets[digit * gl_NumWorkGroups.x + gl_WorkGroupID.x] + countOf(low, high, digit) + ranks[i];
+        u_KeysOut[destination]   = keys[i];
+        u_ValuesOut[destination] = u_ValuesIn[base + i];
+    }
+}
+)";
+
+        constexpr const char* DispatchArgumentsSource = R"(
+layout(local_size_x = 1) in;
+
+layout(std430, binding = 0) readonly buffer Count { uint u_Count; };
+layout(std430, binding = 1) writeonly buffer Arguments { uint u_Arguments[]; };
+
+layout(location = 0) uniform uint u_GroupSize;
+layout(location = 1) uniform uint u_Offset;
+
+void main() {
+    u_Arguments[u_Offset]      = (u_Count + u_GroupSize - 1u) / u_GroupSize;
+    u_Arguments[u_Offset + 1u] = 1u;
+    u_Arguments[u_Offset + 2u] = 1u;
+}
+)";
+
+        // Every invocation folds four strided elements before the shared-memory tree, so each group reduces 1024.
+        constexpr const char* ReduceSource = R"(
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) readonly buffer Input { T u_Input[]; };
+layout(std430, binding = 1) writeonly buffer Output { T u_Output[]; };
+
+layout(location = 0) uniform uint u_Count;
+
+shared T s_Values[256];
+
+void main() {
+    uint local = gl_LocalInvocationID.x;
+    uint base  = gl_WorkGroupID.x * 1024u + local;
+
+    T value = IDENTITY;
+    for (uint i = 0u; i < 4u; i++) {
+        uint index = base + i * 256u;
+        if (index < u_Count)
+            value = OP(value, u_Input[index]);
+    }
+
+    s_Values[local] = value;
+    barrier();
+    for (uint stride = 128u; stride > 0u; stride >>= 1u) {
+        if (local < stride)
+            s_Values[local] = OP(s_Values[local], s_Values[local + stride]);
+        barrier();
+    }
+
+    if (local == 0u)
+        u_Output[gl_WorkGroupID.x] = s_Values[0];
+}
+)";
+
+        constexpr std::array<const char*, 3> ReduceTypes = {
+            "#define T uint\n",
+            "#define T int\n",
+            "#define T float\n",
+        };
+
+        // Indexed [op][type].
+        constexpr std::array<std::array<const char*, 3>, 3> ReduceOps = {{
+            {"#define OP(a, b) ((a) + (b))\n#define IDENTITY 0u\n", "#define OP(a, b) ((a) + (b))\n#define IDENTITY 0\n",
+             "#define OP(a, b) ((a) + (b))\n#define IDENTITY 0.0\n"},
+            {"#define OP(a, b) min(a, b)\n#define IDENTITY 0xFFFFFFFFu\n", "#define OP(a, b) min(a, b)\n#define IDENTITY 0x7FFFFFFF\n",
+             "#define OP(a, b) min(a, b)\n#define IDENTITY uintBitsToFloat(0x7F800000u)\n"},
+            {"#define OP(a, b) max(a, b)\n#define IDENTITY 0u\n", "#define OP(a, b) max(a, b)\n#define IDENTITY (-0x7FFFFFFF - 1)\n",
+             "#define OP(a, b) max(a, b)\n#define IDENTITY uintBitsToFloat(0xFF800000u)\n"},
+        }};
+
+        // local_size_x of every kernel; scan, reduce and sort blocks are four elements per invocation.
+        constexpr uint32_t GroupSize = 256;
+
+        constexpr uint32_t ScanInclusive = 1;
+        constexpr uint32_t ScanBlockSums = 2;
+        constexpr uint32_t ScanBinarize  = 4;
+
+        constexpr size_t ReduceVariants = ReduceTypes.size() * ReduceOps.size();
+
+        constexpr uint32_t DivideRoundUp(uint32_t value, uint32_t divisor) {
+            return (value + divisor - 1) / divisor;
+        }
+
+        constexpr auto Storage = glw::Buffer::Target::ShaderStorage;
+
+        // What a caller may do with a primitive's output once it returns.
+        constexpr auto ResultBarriers = glw::BarrierBit::ShaderStorage | glw::BarrierBit::BufferUpdate | glw::BarrierBit::Command;
+
+        void Bind(std::initializer_list<const glw::Buffer*> buffers) {
+            glw::BindBuffersBase(Storage, 0, std::span<const glw::Buffer* const>(buffers.begin(), buffers.size()));
+        }
+    } // namespace
+
+    ComputePrimitives::ComputePrimitives() : m_Programs(static_cast<size_t>(Kernel::Reduce) + ReduceVariants) {
+        m_MaxGroups = static_cast<uint32_t>(glw::GetCapabilities().maxComputeWorkGroupCount[0]);
+    }
+
+    ComputePrimitives::~ComputePrimitives() = default;
+
+    const glw::Program& ComputePrimitives::getProgram(Kernel kernel, size_t variant) {
+        auto& program = m_Programs[static_cast<size_t>(kernel) + variant];
+        if (program)
+            return *program;
+
+        std::string source = "#version 450\n";
+        switch (kernel) {
+        case Kernel::ScanLocal: source += ScanLocalSource; break;
+        case Kernel::ScanAdd: source += ScanAddSource; break;
+        case Kernel::CompactScatter: source += CompactScatterSource; break;
+        case Kernel::SortHistogram: source += SortHistogramSource; break;
+        case Kernel::SortScatter: source += SortScatterSource; break;
+        case Kernel::DispatchArguments: source += DispatchArgumentsSource; break;
+        case Kernel::Reduce:
+            source += ReduceTypes[variant % ReduceTypes.size()];
+            source += ReduceOps[variant / ReduceTypes.size()][variant % ReduceTypes.size()];
+            source += ReduceSource;
+            break;
+        }
+
+        program = glw::Program::create({{glw::Shader::Type::Compute, source}});
+        if (!program->isLinked())
+            throw std::runtime_error("Failed to build compute primitive: " + program->getInfoLog());
+        return *program;
+    }
+
+    glw::Buffer& ComputePrimitives::getScratch(std::unique_ptr<glw::Buffer>& buffer, size_t size) {
+        if (!buffer || buffer->getCurrentSize() < size)
+            buffer = glw::Buffer::createStorageUnique(std::bit_ceil(std::max<size_t>(size, 256)), nullptr, glw::Buffer::StorageFlags::None);
+        return *buffer;
+    }
+
+    void ComputePrimitives::dispatch(const glw::Program& program, uint32_t groups) {
+        if (groups > m_MaxGroups)
+            throw std::runtime_error(fmt::format("Compute primitive needs {} workgroups, the limit is {}", groups, m_MaxGroups));
+
+        // Inputs may still have pending writes from ComputePipeline dispatches.
+        glw::InsertPendingBarriers(glw::BarrierBit::ShaderStorage);
+        program.use();
+        glw::DispatchCompute(groups);
+    }
+
+    void ComputePrimitives::scan(const glw::Buffer& input, glw::Buffer& output, uint32_t count, uint32_t flags, size_t level) {
+        uint32_t groups = DivideRoundUp(count, ScanBlockSize);
+        const auto& local = getProgram(Kernel::ScanLocal);
+
+        if (groups <= 1) {
+            Bind({&input, &output, &output});
+            local.setUniform(0, count);
+            local.setUniform(1, flags);
+            dispatch(local, 1);
+            return;
+        }
+
+        // Block totals are scanned recursively (exclusive, in place) and added back to every element of their block.
+        if (m_ScanSums.size() <= level)
+            m_ScanSums.resize(level + 1);
+        auto& sums = getScratch(m_ScanSums[level], groups * sizeof(uint32_t));
+
+        Bind({&input, &output, &sums});
+        local.setUniform(0, count);
+        local.setUniform(1, flags | ScanBlockSums);
+        dispatch(local, groups);
+        glw::InsertMemoryBarrier(glw::BarrierBit::ShaderStorage);
+
+        scan(sums, sums, groups, 0, level + 1);
+        glw::InsertMemoryBarrier(glw::BarrierBit::ShaderStorage);
+
+        const auto& add = getProgram(Kernel::ScanAdd);
+        Bind({nullptr, &output, &sums});
+        add.setUniform(0, count);
+        dispatch(add, groups);
+    }
+
+    void ComputePrimitives::exclusiveScan(const glw::Buffer& input, glw::Buffer& output, uint32_t count) {
+        ENGINE_PROFILE_FUNCTION();
+        if (count == 0)
+            return;
+
+        scan(input, output, count, 0, 0);
+        glw::InsertMemoryBarrier(ResultBarriers);
+    }
+
+    void ComputePrimitives::inclusiveScan(const glw::Buffer& input, glw::Buffer& output, uint32_t count) {
+        ENGINE_PROFILE_FUNCTION();
+        if (count == 0)
+            return;
+
+        scan(input, output, count, ScanInclusive, 0);
+        glw::InsertMemoryBarrier(ResultBarriers);
+    }
+
+    void ComputePrimitives::reduce(const glw::Buffer& input, glw::Buffer& result, uint32_t count, ReduceOp op, ValueType type) {
+        ENGINE_PROFILE_FUNCTION();
+        if (count == 0)
+            throw std::runtime_error("Cannot reduce an empty range");
+
+        const auto& program = getProgram(Kernel::Reduce, static_cast<size_t>(op) * ReduceTypes.size() + static_cast<size_t>(type));
+
+        // Each pass shrinks the range by ReduceBlockSize, ping-ponging partials until one group writes the result.
+        const glw::Buffer* source = &input;
+        for (size_t pass = 0;; pass++) {
+            uint32_t groups = DivideRoundUp(count, ReduceBlockSize);
+            auto&    target = groups == 1 ? result : getScratch(m_ReducePartials[pass & 1], groups * sizeof(uint32_t));
+
+            Bind({source, &target});
+            program.setUniform(0, count);
+            dispatch(program, groups);
+            glw::InsertMemoryBarrier(groups == 1 ? ResultBarriers : glw::BarrierBit::ShaderStorage);
+
+            if (groups == 1)
+                break;
+            source = &target;
+            count  = groups;
+        }
+    }
+
+    void ComputePrimitives::compact(const glw::Buffer& input, const glw::Buffer& flags, glw::Buffer& output, glw::Buffer& keptCount, uint32_t count) {
+        ENGINE_PROFILE_FUNCTION();
+        if (count == 0) {
+            keptCount.clear(0, sizeof(uint32_t), GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT);
+            return;
+        }
+
+        auto& indices = getScratch(m_CompactIndices, count * sizeof(uint32_t));
+        scan(flags, indices, count, ScanBinarize, 0);
+        glw::InsertMemoryBarrier(glw::BarrierBit::ShaderStorage);
+
+        const auto& scatter = getProgram(Kernel::CompactScatter);
+        Bind({&input, &flags, &indices, &output, &keptCount});
+        scatter.setUniform(0, count);
+        dispatch(scatter, DivideRoundUp(count, GroupSize));
+        glw::InsertMemoryBarrier(ResultBarriers);
+    }
+
+    void ComputePrimitives::sortPairs(glw::Buffer& keys, glw::Buffer& values, uint32_t count, unsigned int keyBits) {
+        ENGINE_PROFILE_FUNCTION();
+        if (count <= 1 || keyBits == 0)
+            return;
+
+        uint32_t blocks    = DivideRoundUp(count, SortBlockSize);
+        uint32_t bins      = blocks << RadixBits;
+        auto&    histogram = getScratch(m_SortHistogram, bins * sizeof(uint32_t));
+
+        const auto& histogramProgram = getProgram(Kernel::SortHistogram);
+        const auto& scatterProgram   = getProgram(Kernel::SortScatter);
+
+        std::array<glw::Buffer*, 2> keyBuffers   = {&keys, &getScratch(m_SortKeys, count * sizeof(uint32_t))};
+        std::array<glw::Buffer*, 2> valueBuffers = {&values, &getScratch(m_SortValues, count * sizeof(uint32_t))};
+
+        unsigned int passes = (std::min(keyBits, 32u) + RadixBits - 1) / RadixBits;
+        for (unsigned int pass = 0; pass < passes; pass++) {
+            uint32_t shift    = pass * RadixBits;
+            auto*    keysIn   = keyBuffers[pass & 1];
+            auto*    valuesIn = valueBuffers[pass & 1];
+
+            Bind({keysIn, nullptr, nullptr, nullptr, &histogram});
+            histogramProgram.setUniform(0, count);
+            histogramProgram.setUniform(1, shift);
+            dispatch(histogramProgram, blocks);
+            glw::InsertMemoryBarrier(glw::BarrierBit::ShaderStorage);
+
+            scan(histogram, histogram, bins, 0, 0);
+            glw::InsertMemoryBarrier(glw::BarrierBit::ShaderStorage);
+
+            Bind({keysIn, valuesIn, keyBuffers[~pass & 1], valueBuffers[~pass & 1], &histogram});
+            scatterProgram.setUniform(0, count);
+            scatterProgram.setUniform(1, shift);
+            dispatch(scatterProgram, blocks);
+            glw::InsertMemoryBarrier(glw::BarrierBit::ShaderStorage);
+        }
+
+        // An odd pass count leaves the result in scratch.
+        if (passes & 1) {
+            glw::InsertMemoryBarrier(glw::BarrierBit::BufferUpdate);
+            keyBuffers[1]->copyTo(&keys, count * sizeof(uint32_t));
+            valueBuffers[1]->copyTo(&values, count * sizeof(uint32_t));
+        }
+        glw::InsertMemoryBarrier(ResultBarriers);
+    }
+
+    void ComputePrimitives::writeDispatchArguments(const glw::Buffer& count, glw::Buffer& arguments, uint32_t threadsPerGroup, size_t offset) {
+        if (threadsPerGroup == 0 || offset % sizeof(uint32_t) != 0)
+            throw std::runtime_error("Dispatch arguments need a non-zero group size and a 4-byte aligned offset");
+
+        const auto& program = getProgram(Kernel::DispatchArguments);
+        Bind({&count, &arguments});
+        program.setUniform(0, threadsPerGroup);
+        program.setUniform(1, static_cast<uint32_t>(offset / sizeof(uint32_t)));
+        dispatch(program, 1);
+        glw::InsertMemoryBarrier(ResultBarriers);
+    }
+
+    namespace reference {
+        void ExclusiveScan(std::span<const uint32_t> input, std::span<uint32_t> output) {
+            std::exclusive_scan(input.begin(), input.end(), output.begin(), 0u);
+        }
+
+        void InclusiveScan(std::span<const uint32_t> input, std::span<uint32_t> output) {
+            std::inclusive_scan(input.begin(), input.end(), output.begin());
+        }
+
+        template<typename T>
+        T Reduce(std::span<const T> input, ComputePrimitives::ReduceOp op) {
+            switch (op) {
+            case ComputePrimitives::ReduceOp::Sum: return std::accumulate(input.begin(), input.end(), T{});
+            case ComputePrimitives::ReduceOp::Min:
+                return std::accumulate(input.begin(), input.end(), std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max(),
+                                       [](T a, T b) { return std::min(a, b); });
+            case ComputePrimitives::ReduceOp::Max:
+                return std::accumulate(input.begin(), input.end(), std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest(),
+                                       [](T a, T b) { return std::max(a, b); });
+            }
+            return T{};
+        }
+
+        template uint32_t Reduce<uint32_t>(std::span<const uint32_t>, ComputePrimitives::ReduceOp);
+        template int32_t  Reduce<int32_t>(std::span<const int32_t>, ComputePrimitives::ReduceOp);
+        template float    Reduce<float>(std::span<const float>, ComputePrimitives::ReduceOp);
+
+        size_t Compact(std::span<const uint32_t> input, std::span<const uint32_t> flags, std::span<uint32_t> output) {
+            size_t kept = 0;
+            for (size_t i = 0; i < input.size(); i++)
+                if (flags[i] != 0)
+                    output[kept++] = input[i];
+            return kept;
+        }
+
+        void SortPairs(std::span<uint32_t> keys, std::span<uint32_t> values, unsigned int keyBits) {
+            unsigned int bits = (std::min(keyBits, 32u) + ComputePrimitives::RadixBits - 1) / ComputePrimitives::RadixBits * ComputePrimitives::RadixBits;
+            uint32_t     mask = bits >= 32 ? ~0u : (1u << bits) - 1u;
+
+            std::vector<size_t> order(keys.size());
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return (keys[a] & mask) < (keys[b] & mask); });
+
+            std::vector<uint32_t> sortedKeys(keys.size()), sortedValues(values.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                sortedKeys[i]   = keys[order[i]];
+                sortedValues[i] = values[order[i]];
+            }
+            std::copy(sortedKeys.begin(), sortedKeys.end(), keys.begin());
+            std::copy(sortedValues.begin(), sortedValues.end(), values.begin());
+        }
+    } // namespace reference
+
+} // namespace engine
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "engine/gl.hpp"
+
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace engine {
+
+    // Data-parallel building blocks on shader storage buffers of 32-bit elements. Each call records its compute passes
+    // and returns without waiting; results are visible to later shader storage reads, buffer copies/readbacks and
+    // indirect commands. Programs are built on first use and scratch buffers only ever grow.
+    class ComputePrimitives {
+      public:
+        enum class ReduceOp {
+            Sum,
+            Min,
+            Max,
+        };
+
+        enum class ValueType {
+            Uint,
+            Int,
+            Float,
+        };
+
+        ComputePrimitives();
+        ~ComputePrimitives();
+
+        ComputePrimitives(const ComputePrimitives&)            = delete;
+        ComputePrimitives& operator=(const ComputePrimitives&) = delete;
+
+        // Prefix sums of uint elements; input and output may be the same buffer.
+        void exclusiveScan(const glw::Buffer& input, glw::Buffer& output, uint32_t count);
+        void inclusiveScan(const glw::Buffer& input, glw::Buffer& output, uint32_t count);
+
+        // Writes the reduction of `count` (> 0) elements to the first element of `result`.
+        void reduce(const glw::Buffer& input, glw::Buffer& result, uint32_t count, ReduceOp op, ValueType type = ValueType::Uint);
+
+        // Stable: copies input[i] for every non-zero flags[i] to the front of `output` and writes how many were kept to
+        // the first uint of `keptCount`, so the result can drive indirect draws or dispatches without a readback.
+        void compact(const glw::Buffer& input, const glw::Buffer& flags, glw::Buffer& output, glw::Buffer& keptCount, uint32_t count);
+
+        // Stable LSD radix sort of uint keys carrying uint values, in place. Keys are compared on their low `keyBits`
+        // bits rounded up to a whole number of RadixBits passes.
+        void sortPairs(glw::Buffer& keys, glw::Buffer& values, uint32_t count, unsigned int keyBits = 32);
+
+        // Writes a DispatchIndirectCommand covering the uint element count at the start of `count` (e.g. the kept count
+        // of compact()) with groups of `threadsPerGroup`, so follow-up work can be dispatched without a readback.
+        void writeDispatchArguments(const glw::Buffer& count, glw::Buffer& arguments, uint32_t threadsPerGroup, size_t offset = 0);
+
+        static constexpr uint32_t ScanBlockSize   = 1024;
+        static constexpr uint32_t ReduceBlockSize = 1024;
+        static constexpr uint32_t SortBlockSize   = 1024;
+        static constexpr uint32_t RadixBits       = 4;
+
+      private:
+        enum class Kernel {
+            ScanLocal,
+            ScanAdd,
+            CompactScatter,
+            SortHistogram,
+            SortScatter,
+            DispatchArguments,
+            Reduce,
+        };
+
+        const glw::Program& getProgram(Kernel kernel, size_t variant = 0);
+        glw::Buffer&        getScratch(std::unique_ptr<glw::Buffer>& buffer, size_t size);
+
+        void scan(const glw::Buffer& input, glw::Buffer& output, uint32_t count, uint32_t flags, size_t level);
+        void dispatch(const glw::Program& program, uint32_t groups);
+
+        std::vector<std::shared_ptr<glw::Program>> m_Programs;
+        std::vector<std::unique_ptr<glw::Buffer>>  m_ScanSums;
+        std::array<std::unique_ptr<glw::Buffer>, 2> m_ReducePartials;
+        std::unique_ptr<glw::Buffer>               m_CompactIndices;
+        std::unique_ptr<glw::Buffer>               m_SortHistogram;
+        std::unique_ptr<glw::Buffer>               m_SortKeys;
+        std::unique_ptr<glw::Buffer>               m_SortValues;
+        uint32_t                                   m_MaxGroups = 0;
+    };
+
+    // Sequential reference implementations with the same semantics as the GPU primitives, for validation.
+    namespace reference {
+        void ExclusiveScan(std::span<const uint32_t> input, std::span<uint32_t> output);
+        void InclusiveScan(std::span<const uint32_t> input, std::span<uint32_t> output);
+
+        template<typename T>
+        [[nodiscard]] T Reduce(std::span<const T> input, ComputePrimitives::ReduceOp op);
+
+        // Returns the number of elements kept.
+        size_t Compact(std::span<const uint32_t> input, std::span<const uint32_t> flags, std::span<uint32_t> output);
+
+        void SortPairs(std::span<uint32_t> keys, std::span<uint32_t> values, unsigned int keyBits = 32);
+    } // namespace reference
+
+} // namespace engine
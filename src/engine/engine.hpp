@@ -13,6 +13,9 @@
 #include <cassert>
 #include <cstring>
 
+#define ENGINE_CONCAT_INNER(a, b) a##b
+#define ENGINE_CONCAT(a, b) ENGINE_CONCAT_INNER(a, b)
+
 namespace engine {
     template<typename T>
     struct range {
@@ -1,32 +1,279 @@
 #include "engine/gl.hpp"
+#include "engine/profiler.hpp"
 
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+
 namespace glw {
-    void load() {
-        gladLoadGL(glfwGetProcAddress);
+    static constexpr std::array<std::string_view, static_cast<size_t>(Extension::Count)> ExtensionNames = {
+        "GL_ARB_buffer_storage",
+        "GL_ARB_clip_control",
+        "GL_ARB_compute_shader",
+        "GL_ARB_direct_state_access",
+        "GL_ARB_gl_spirv",
+        "GL_ARB_indirect_parameters",
+        "GL_ARB_invalidate_subdata",
+        "GL_ARB_multi_bind",
+        "GL_ARB_multi_draw_indirect",
+        "GL_ARB_parallel_shader_compile",
+        "GL_ARB_pipeline_statistics_query",
+        "GL_ARB_program_interface_query",
+        "GL_ARB_query_buffer_object",
+        "GL_ARB_sampler_objects",
+        "GL_ARB_shader_draw_parameters",
+        "GL_ARB_shader_image_load_store",
+        "GL_ARB_shader_storage_buffer_object",
+        "GL_ARB_sparse_buffer",
+        "GL_ARB_sparse_texture",
+        "GL_ARB_spirv_extensions",
+        "GL_ARB_texture_filter_anisotropic",
+        "GL_ARB_timer_query",
+        "GL_ARB_bindless_texture",
+        "GL_ATI_meminfo",
+        "GL_EXT_texture_filter_anisotropic",
+        "GL_KHR_debug",
+        "GL_KHR_no_error",
+        "GL_KHR_parallel_shader_compile",
+        "GL_NVX_gpu_memory_info",
+    };
+
+    // Extension names are mapped to Extension bits through a perfect hash built at compile time, so
+    // load() classifies each driver-reported name with one hash and one string compare.
+    static constexpr size_t   ExtensionTableSize = 128;
+    static constexpr uint16_t ExtensionTableEmpty = 0xFFFF;
+
+    static constexpr uint32_t HashExtensionName(std::string_view name, uint32_t seed) {
+        uint32_t h = 2166136261u ^ seed;
+        for (char c : name) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 16777619u;
+        }
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h;
     }
 
-    std::vector<std::string> GetExtensions() {
-        std::vector<std::string> extensions;
-        int count = GetInteger(GL_NUM_EXTENSIONS);
-        extensions.reserve(count);
-        for (unsigned int i = 0 ; i < count ; i++) {
-            extensions.push_back(GetStringi(GL_EXTENSIONS, i));
+    static constexpr uint32_t FindExtensionHashSeed() {
+        for (uint32_t seed = 0; seed < 4096; seed++) {
+            std::array<bool, ExtensionTableSize> used{};
+            bool                                 collision = false;
+            for (auto name : ExtensionNames) {
+                size_t slot = HashExtensionName(name, seed) % ExtensionTableSize;
+                if (used[slot]) {
+                    collision = true;
+                    break;
+                }
+                used[slot] = true;
+            }
+            if (!collision)
+                return seed;
         }
+        return UINT32_MAX;
+    }
 
-        return extensions;
+    static constexpr uint32_t ExtensionHashSeed = FindExtensionHashSeed();
+    static_assert(ExtensionHashSeed != UINT32_MAX, "No collision-free seed for the extension table; grow ExtensionTableSize");
+
+    static constexpr std::array<uint16_t, ExtensionTableSize> ExtensionTable = [] {
+        std::array<uint16_t, ExtensionTableSize> table{};
+        table.fill(ExtensionTableEmpty);
+        for (size_t i = 0; i < ExtensionNames.size(); i++) {
+            table[HashExtensionName(ExtensionNames[i], ExtensionHashSeed) % ExtensionTableSize] = static_cast<uint16_t>(i);
+        }
+        return table;
+    }();
+
+    static Capabilities s_Capabilities;
+
+    static std::vector<std::string> QueryStringList(GLenum countName, GLenum name) {
+        std::vector<std::string> strings;
+        int                      count = GetInteger(countName);
+        strings.reserve(count);
+        for (int i = 0; i < count; i++) {
+            strings.push_back(GetStringi(name, i));
+        }
+
+        return strings;
     }
 
-    std::vector<std::string> GetSpirVExtensions() {
-        std::vector<std::string> extensions;
-        int count = GetInteger(GL_NUM_SPIR_V_EXTENSIONS);
-        extensions.reserve(count);
-        for (unsigned int i = 0 ; i < count ; i++) {
-            extensions.push_back(GetStringi(GL_SPIR_V_EXTENSIONS, i));
+    static void QueryCapabilities(Capabilities &caps) {
+        caps.versionMajor           = GetInteger(GL_MAJOR_VERSION);
+        caps.versionMinor           = GetInteger(GL_MINOR_VERSION);
+        caps.version                = GetString(GL_VERSION);
+        caps.vendor                 = GetString(GL_VENDOR);
+        caps.renderer               = GetString(GL_RENDERER);
+        caps.shadingLanguageVersion = GetString(GL_SHADING_LANGUAGE_VERSION);
+
+        caps.extensions = QueryStringList(GL_NUM_EXTENSIONS, GL_EXTENSIONS);
+        for (const auto &name : caps.extensions) {
+            uint16_t index = ExtensionTable[HashExtensionName(name, ExtensionHashSeed) % ExtensionTableSize];
+            if (index != ExtensionTableEmpty && ExtensionNames[index] == name)
+                caps.extensionBits.set(index);
         }
 
-        return extensions;
+        if (caps.hasVersion(4, 6) || caps.has(Extension::ARB_spirv_extensions))
+            caps.spirvExtensions = QueryStringList(GL_NUM_SPIR_V_EXTENSIONS, GL_SPIR_V_EXTENSIONS);
+
+        caps.uniformBufferOffsetAlignment       = GetInteger(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT);
+        caps.shaderStorageBufferOffsetAlignment = GetInteger(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT);
+        caps.textureBufferOffsetAlignment       = GetInteger(GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT);
+        caps.minMapBufferAlignment              = GetInteger(GL_MIN_MAP_BUFFER_ALIGNMENT);
+        caps.maxUniformBlockSize                = GetInteger(GL_MAX_UNIFORM_BLOCK_SIZE);
+        glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &caps.maxShaderStorageBlockSize);
+        caps.maxUniformBufferBindings       = GetInteger(GL_MAX_UNIFORM_BUFFER_BINDINGS);
+        caps.maxShaderStorageBufferBindings = GetInteger(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS);
+        caps.maxAtomicCounterBufferBindings = GetInteger(GL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS);
+        caps.maxCombinedTextureImageUnits   = GetInteger(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
+        caps.maxImageUnits                  = GetInteger(GL_MAX_IMAGE_UNITS);
+        caps.maxVertexAttribs               = GetInteger(GL_MAX_VERTEX_ATTRIBS);
+        caps.maxVertexAttribBindings        = GetInteger(GL_MAX_VERTEX_ATTRIB_BINDINGS);
+        caps.maxTextureSize                 = GetInteger(GL_MAX_TEXTURE_SIZE);
+        caps.max3DTextureSize               = GetInteger(GL_MAX_3D_TEXTURE_SIZE);
+        caps.maxArrayTextureLayers          = GetInteger(GL_MAX_ARRAY_TEXTURE_LAYERS);
+        caps.maxSamples                     = GetInteger(GL_MAX_SAMPLES);
+        caps.maxColorAttachments            = GetInteger(GL_MAX_COLOR_ATTACHMENTS);
+        caps.maxDrawBuffers                 = GetInteger(GL_MAX_DRAW_BUFFERS);
+
+        for (GLuint i = 0; i < 3; i++) {
+            caps.maxComputeWorkGroupCount[i] = GetIntegeri(GL_MAX_COMPUTE_WORK_GROUP_COUNT, i);
+            caps.maxComputeWorkGroupSize[i]  = GetIntegeri(GL_MAX_COMPUTE_WORK_GROUP_SIZE, i);
+        }
+        caps.maxComputeWorkGroupInvocations = GetInteger(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS);
+        caps.maxComputeSharedMemorySize     = GetInteger(GL_MAX_COMPUTE_SHARED_MEMORY_SIZE);
+
+        if (caps.hasVersion(4, 6) || caps.has(Extension::ARB_texture_filter_anisotropic) || caps.has(Extension::EXT_texture_filter_anisotropic))
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &caps.maxTextureMaxAnisotropy);
+
+        glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &caps.timestampBits);
+    }
+
+    namespace detail {
+        Backend g_Backend;
+
+        static void ReplaceBufferDataInvalidate(GLuint buffer, GLsizeiptr size, const void *data, GLenum) {
+            glInvalidateBufferData(buffer);
+            glNamedBufferSubData(buffer, 0, size, data);
+        }
+
+        static void ReplaceBufferDataOrphan(GLuint buffer, GLsizeiptr size, const void *data, GLenum usage) {
+            glNamedBufferData(buffer, size, nullptr, usage);
+            glNamedBufferSubData(buffer, 0, size, data);
+        }
+
+        static void MultiDrawArraysIndirectCountCore(GLenum mode, const void *indirect, GLintptr drawCount, GLsizei maxDrawCount, GLsizei stride) {
+            glMultiDrawArraysIndirectCount(mode, indirect, drawCount, maxDrawCount, stride);
+        }
+
+        static void MultiDrawElementsIndirectCountCore(GLenum mode, GLenum type, const void *indirect, GLintptr drawCount, GLsizei maxDrawCount, GLsizei stride) {
+            glMultiDrawElementsIndirectCount(mode, type, indirect, drawCount, maxDrawCount, stride);
+        }
+
+        static void MultiDrawArraysIndirectCountARB(GLenum mode, const void *indirect, GLintptr drawCount, GLsizei maxDrawCount, GLsizei stride) {
+            glMultiDrawArraysIndirectCountARB(mode, indirect, drawCount, maxDrawCount, stride);
+        }
+
+        static void MultiDrawElementsIndirectCountARB(GLenum mode, GLenum type, const void *indirect, GLintptr drawCount, GLsizei maxDrawCount, GLsizei stride) {
+            glMultiDrawElementsIndirectCountARB(mode, type, indirect, drawCount, maxDrawCount, stride);
+        }
+
+        static void MultiDrawArraysIndirectCountFallback(GLenum mode, const void *indirect, GLintptr, GLsizei maxDrawCount, GLsizei stride) {
+            glMultiDrawArraysIndirect(mode, indirect, maxDrawCount, stride);
+        }
+
+        static void MultiDrawElementsIndirectCountFallback(GLenum mode, GLenum type, const void *indirect, GLintptr, GLsizei maxDrawCount, GLsizei stride) {
+            glMultiDrawElementsIndirect(mode, type, indirect, maxDrawCount, stride);
+        }
+
+        static bool IsShaderCompileCompleteParallel(GLuint shader) {
+            int b;
+            glGetShaderiv(shader, GL_COMPLETION_STATUS_KHR, &b);
+            return b == GL_TRUE;
+        }
+
+        static bool IsProgramLinkCompleteParallel(GLuint program) {
+            int b;
+            glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &b);
+            return b == GL_TRUE;
+        }
+
+        static bool IsCompleteSynchronous(GLuint) {
+            return true;
+        }
+
+        static void SelectBackend(const Capabilities &caps, Backend &backend) {
+            if (caps.hasVersion(4, 3) || caps.has(Extension::ARB_invalidate_subdata)) {
+                backend.replaceBufferData     = ReplaceBufferDataInvalidate;
+                backend.replaceBufferDataName = "invalidate+subdata";
+            } else {
+                backend.replaceBufferData     = ReplaceBufferDataOrphan;
+                backend.replaceBufferDataName = "orphan+subdata";
+            }
+
+            if (caps.hasVersion(4, 6)) {
+                backend.multiDrawArraysIndirectCount   = MultiDrawArraysIndirectCountCore;
+                backend.multiDrawElementsIndirectCount = MultiDrawElementsIndirectCountCore;
+                backend.multiDrawIndirectCountName     = "core indirect count";
+            } else if (caps.has(Extension::ARB_indirect_parameters)) {
+                backend.multiDrawArraysIndirectCount   = MultiDrawArraysIndirectCountARB;
+                backend.multiDrawElementsIndirectCount = MultiDrawElementsIndirectCountARB;
+                backend.multiDrawIndirectCountName     = "ARB_indirect_parameters";
+            } else {
+                backend.multiDrawArraysIndirectCount   = MultiDrawArraysIndirectCountFallback;
+                backend.multiDrawElementsIndirectCount = MultiDrawElementsIndirectCountFallback;
+                backend.multiDrawIndirectCountName     = "plain multi-draw indirect";
+            }
+
+            if (caps.has(Extension::KHR_parallel_shader_compile)) {
+                glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+                backend.isShaderCompileComplete = IsShaderCompileCompleteParallel;
+                backend.isProgramLinkComplete   = IsProgramLinkCompleteParallel;
+                backend.shaderCompileName       = "KHR_parallel_shader_compile";
+            } else if (caps.has(Extension::ARB_parallel_shader_compile)) {
+                glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+                backend.isShaderCompileComplete = IsShaderCompileCompleteParallel;
+                backend.isProgramLinkComplete   = IsProgramLinkCompleteParallel;
+                backend.shaderCompileName       = "ARB_parallel_shader_compile";
+            } else {
+                backend.isShaderCompileComplete = IsCompleteSynchronous;
+                backend.isProgramLinkComplete   = IsCompleteSynchronous;
+                backend.shaderCompileName       = "synchronous";
+            }
+        }
+    }
+
+    void load() {
+        load(glfwGetProcAddress);
+    }
+
+    void load(ProcLoader loader) {
+        ENGINE_PROFILE_FUNCTION();
+
+        if (!gladLoadGL(loader))
+            throw std::runtime_error("Failed to load OpenGL functions");
+
+        QueryCapabilities(s_Capabilities);
+        detail::SelectBackend(s_Capabilities, detail::g_Backend);
+
+        spdlog::debug("glw backend: buffer replace = {}, indirect count = {}, shader compile = {}", detail::g_Backend.replaceBufferDataName,
+                      detail::g_Backend.multiDrawIndirectCountName, detail::g_Backend.shaderCompileName);
+    }
+
+    const Capabilities &GetCapabilities() {
+        return s_Capabilities;
+    }
+
+    const std::vector<std::string> &GetExtensions() {
+        return s_Capabilities.extensions;
+    }
+
+    const std::vector<std::string> &GetSpirVExtensions() {
+        return s_Capabilities.spirvExtensions;
     }
 
     int GetInteger(GLenum pname) {
@@ -49,13 +296,138 @@ namespace glw {
         return reinterpret_cast<const char*>(glGetStringi(pname, i));
     }
 
+    void ResetFrameStats() {
+        GLW_CAPTURE(FrameEnd);
+        detail::t_LastFrameStats = detail::t_FrameStats;
+        detail::t_FrameStats     = {};
+    }
+
+    void LogFrameStats(const FrameStats &stats) {
+        for (const auto &[name, field] : FrameStatsFields) {
+            spdlog::info("{:>24}: {}", name, stats.*field);
+        }
+    }
+
+    void DrawArrays(GLenum mode, int first, int count, int instanceCount, unsigned int baseInstance) {
+        GLW_CAPTURE(DrawArrays, mode, first, count, instanceCount, baseInstance);
+        InsertPendingBarriers(BarrierBit::VertexAttribArray);
+        detail::t_FrameStats.drawCalls++;
+        glDrawArraysInstancedBaseInstance(mode, first, count, instanceCount, baseInstance);
+    }
+
+    void DrawElements(GLenum mode, int count, GLenum type, size_t offset, int instanceCount, int baseVertex, unsigned int baseInstance) {
+        GLW_CAPTURE(DrawElements, mode, count, type, offset, instanceCount, baseVertex, baseInstance);
+        InsertPendingBarriers(BarrierBit::VertexAttribArray | BarrierBit::ElementArray);
+        detail::t_FrameStats.drawCalls++;
+        glDrawElementsInstancedBaseVertexBaseInstance(mode, count, type, reinterpret_cast<const void *>(offset), instanceCount, baseVertex, baseInstance);
+    }
+
+    void DispatchCompute(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) {
+        GLW_CAPTURE(DispatchCompute, groupsX, groupsY, groupsZ);
+        detail::t_FrameStats.dispatches++;
+        glDispatchCompute(groupsX, groupsY, groupsZ);
+    }
+
+    void DispatchComputeIndirect(size_t indirectOffset) {
+        GLW_CAPTURE(DispatchComputeIndirect, indirectOffset);
+        InsertPendingBarriers(BarrierBit::Command);
+        detail::t_FrameStats.dispatches++;
+        glDispatchComputeIndirect(static_cast<GLintptr>(indirectOffset));
+    }
+
+    void MultiDrawArraysIndirect(GLenum mode, size_t indirectOffset, int drawCount, int stride) {
+        GLW_CAPTURE(MultiDrawArraysIndirect, mode, indirectOffset, drawCount, stride);
+        InsertPendingBarriers(BarrierBit::VertexAttribArray | BarrierBit::Command);
+        detail::t_FrameStats.indirectDrawCalls++;
+        glMultiDrawArraysIndirect(mode, reinterpret_cast<const void *>(indirectOffset), drawCount, stride);
+    }
+
+    void MultiDrawElementsIndirect(GLenum mode, GLenum type, size_t indirectOffset, int drawCount, int stride) {
+        GLW_CAPTURE(MultiDrawElementsIndirect, mode, type, indirectOffset, drawCount, stride);
+        InsertPendingBarriers(BarrierBit::VertexAttribArray | BarrierBit::ElementArray | BarrierBit::Command);
+        detail::t_FrameStats.indirectDrawCalls++;
+        glMultiDrawElementsIndirect(mode, type, reinterpret_cast<const void *>(indirectOffset), drawCount, stride);
+    }
+
+    bool IsSpirVSupported() {
+        return s_Capabilities.hasVersion(4, 6) || s_Capabilities.has(Extension::ARB_gl_spirv);
+    }
+
+    static constexpr uint32_t SpirVMagic       = 0x07230203;
+    static constexpr size_t   SpirVHeaderWords = 5;
+    static constexpr uint32_t SpirVOpExtension = 10;
+
+    std::vector<uint32_t> ReadSpirV(const std::string &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error("Failed to open SPIR-V module '" + path + "'");
+
+        auto size = static_cast<size_t>(file.tellg());
+        if (size % sizeof(uint32_t) != 0 || size < SpirVHeaderWords * sizeof(uint32_t))
+            throw std::runtime_error("SPIR-V module '" + path + "' has an invalid size");
+
+        std::vector<uint32_t> binary(size / sizeof(uint32_t));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(binary.data()), static_cast<std::streamsize>(size));
+
+        if (binary[0] != SpirVMagic)
+            throw std::runtime_error("SPIR-V module '" + path + "' has an invalid magic number");
+
+        return binary;
+    }
+
+    std::vector<std::string> GetSpirVModuleExtensions(const std::vector<uint32_t> &binary) {
+        std::vector<std::string> extensions;
+
+        size_t i = SpirVHeaderWords;
+        while (i < binary.size()) {
+            uint32_t wordCount = binary[i] >> 16;
+            uint32_t opcode    = binary[i] & 0xFFFF;
+            if (wordCount == 0 || i + wordCount > binary.size())
+                break;
+
+            if (opcode == SpirVOpExtension) {
+                const char *literal = reinterpret_cast<const char *>(&binary[i + 1]);
+                extensions.emplace_back(literal, strnlen(literal, (wordCount - 1) * sizeof(uint32_t)));
+            }
+
+            i += wordCount;
+        }
+
+        return extensions;
+    }
+
+    namespace detail {
+        // Scratch arrays for the multi-bind entry points, reused so batched binds do not allocate.
+        static thread_local std::vector<GLuint>     t_BindHandles;
+        static thread_local std::vector<GLintptr>   t_BindOffsets;
+        static thread_local std::vector<GLsizeiptr> t_BindSizes;
+    } // namespace detail
+
+    static bool InRange(const engine::range<size_t> &range, size_t size) {
+        return range.offset <= size && range.size <= size - range.offset;
+    }
+
+    static bool IsIndexedTarget(GLenum target) {
+        return target == GL_UNIFORM_BUFFER || target == GL_SHADER_STORAGE_BUFFER || target == GL_ATOMIC_COUNTER_BUFFER || target == GL_TRANSFORM_FEEDBACK_BUFFER;
+    }
+
     Buffer::Buffer(size_t size, const void *data, Usage usage) {
         glCreateBuffers(1, &m_Buffer);
+        GLW_CAPTURE(BufferCreate, m_Buffer);
         set(size, data, usage);
 
     }
 
+    Buffer::Buffer(size_t size, const void *data, Buffer::StorageFlags flags) {
+        glCreateBuffers(1, &m_Buffer);
+        GLW_CAPTURE(BufferCreate, m_Buffer);
+        storage(size, data, flags);
+    }
+
     Buffer::~Buffer() {
+        GLW_CAPTURE(BufferDelete, m_Buffer);
+        detail::TrackFree(m_MemoryTag, static_cast<int64_t>(m_CurrentSize));
         glDeleteBuffers(1, &m_Buffer);
     }
 
@@ -67,25 +439,50 @@ namespace glw {
         return std::make_unique<Buffer>(size, data, usage);
     }
 
+    std::shared_ptr<Buffer> Buffer::createStorage(size_t size, const void *data, Buffer::StorageFlags flags) {
+        return std::make_shared<Buffer>(size, data, flags);
+    }
+
+    std::unique_ptr<Buffer> Buffer::createStorageUnique(size_t size, const void *data, Buffer::StorageFlags flags) {
+        return std::make_unique<Buffer>(size, data, flags);
+    }
+
     void Buffer::set(size_t size, const void *data) {
-        if (size != m_CurrentSize)
-            glNamedBufferData(m_Buffer, size, data, static_cast<GLenum>(m_CurrentUsage));
-        else
-            subdata(size, data, 0);
+        set(size, data, m_CurrentUsage);
     }
 
     void Buffer::set(size_t size, const void *data, Buffer::Usage usage) {
-        if (size != m_CurrentSize || usage != m_CurrentUsage)
+        GLW_VALIDATE(!m_Immutable, "buffer {} has immutable storage", m_Buffer);
+        GLW_VALIDATE(!m_Mapped, "buffer {} is mapped", m_Buffer);
+        GLW_CAPTURE(BufferData, m_Buffer, size, static_cast<GLenum>(usage), detail::CaptureBlob{data, size});
+
+        auto &stats = detail::t_FrameStats;
+        if (size != m_CurrentSize || usage != m_CurrentUsage) {
             glNamedBufferData(m_Buffer, size, data, static_cast<GLenum>(usage));
-        else
-            subdata(size, data, 0);
+            trackAllocation(size);
+            m_CurrentUsage = usage;
+        } else if (data) {
+            detail::g_Backend.replaceBufferData(m_Buffer, static_cast<GLsizeiptr>(size), data, static_cast<GLenum>(usage));
+            stats.bufferUploads++;
+            stats.bufferBytesUploaded += size;
+        }
     }
 
     void Buffer::subdata(size_t size, const void *data, size_t offset) {
+        GLW_VALIDATE(InRange({offset, size}, m_CurrentSize), "range [{}, {}) exceeds buffer {} of size {}", offset, offset + size, m_Buffer, m_CurrentSize);
+        GLW_VALIDATE(!m_Mapped || (m_MappedAccess & GL_MAP_PERSISTENT_BIT), "buffer {} is mapped without GL_MAP_PERSISTENT_BIT", m_Buffer);
+        GLW_VALIDATE(!m_Immutable || (m_StorageFlags & StorageFlags::DynamicStorage) == StorageFlags::DynamicStorage,
+                     "buffer {} was allocated without StorageFlags::DynamicStorage", m_Buffer);
+        GLW_CAPTURE(BufferSubData, m_Buffer, offset, detail::CaptureBlob{data, size});
+
+        detail::t_FrameStats.bufferUploads++;
+        detail::t_FrameStats.bufferBytesUploaded += size;
         glNamedBufferSubData(m_Buffer, offset, size, data);
     }
 
     void Buffer::bind(GLenum target) {
+        GLW_CAPTURE(BufferBind, m_Buffer, target);
+        detail::t_FrameStats.bufferBinds++;
         glBindBuffer(target, m_Buffer);
     }
 
@@ -94,6 +491,10 @@ namespace glw {
     }
 
     void Buffer::bindBase(GLenum target, unsigned int index) {
+        GLW_VALIDATE(IsIndexedTarget(target), "target 0x{:X} is not an indexed buffer target", target);
+        GLW_CAPTURE(BufferBindBase, m_Buffer, target, index);
+
+        detail::t_FrameStats.bufferBinds++;
         glBindBufferBase(target, index, m_Buffer);
     }
 
@@ -102,6 +503,15 @@ namespace glw {
     }
 
     void Buffer::bindRange(GLenum target, unsigned int index, const engine::range<size_t> &range) {
+        GLW_VALIDATE(IsIndexedTarget(target), "target 0x{:X} is not an indexed buffer target", target);
+        GLW_VALIDATE(InRange(range, m_CurrentSize), "range [{}, {}) exceeds buffer {} of size {}", range.offset, range.offset + range.size, m_Buffer, m_CurrentSize);
+        GLW_VALIDATE(target != GL_UNIFORM_BUFFER || range.offset % GetCapabilities().uniformBufferOffsetAlignment == 0,
+                     "offset {} is not a multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT", range.offset);
+        GLW_VALIDATE(target != GL_SHADER_STORAGE_BUFFER || range.offset % GetCapabilities().shaderStorageBufferOffsetAlignment == 0,
+                     "offset {} is not a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT", range.offset);
+        GLW_CAPTURE(BufferBindRange, m_Buffer, target, index, range.offset, range.size);
+
+        detail::t_FrameStats.bufferBinds++;
         glBindBufferRange(target, index, m_Buffer, range.offset, range.size);
     }
 
@@ -110,15 +520,50 @@ namespace glw {
     }
 
     void Buffer::storage(size_t size, const void *data, Buffer::Usage usage) {
+        GLW_VALIDATE(!m_Immutable, "buffer {} already has immutable storage", m_Buffer);
+        GLW_CAPTURE(BufferStorage, m_Buffer, size, static_cast<GLbitfield>(usage), detail::CaptureBlob{data, size});
+
+        trackAllocation(size);
+        m_Immutable    = true;
         m_CurrentUsage = usage;
         glNamedBufferStorage(m_Buffer, size, data, static_cast<GLenum>(usage));
     }
 
+    void Buffer::storage(size_t size, const void *data, Buffer::StorageFlags flags) {
+        GLW_VALIDATE(!m_Immutable, "buffer {} already has immutable storage", m_Buffer);
+        GLW_CAPTURE(BufferStorage, m_Buffer, size, static_cast<GLbitfield>(flags), detail::CaptureBlob{data, size});
+
+        trackAllocation(size);
+        m_Immutable    = true;
+        m_CurrentUsage = Usage::Unset;
+        m_StorageFlags = flags;
+        glNamedBufferStorage(m_Buffer, size, data, static_cast<GLbitfield>(flags));
+    }
+
+    void Buffer::setMemoryTag(MemoryTag tag) {
+        detail::TrackTransfer(m_MemoryTag, tag, static_cast<int64_t>(m_CurrentSize));
+        m_MemoryTag = tag;
+    }
+
+    void Buffer::trackAllocation(size_t size) {
+        detail::t_FrameStats.bufferAllocations++;
+        detail::t_FrameStats.bufferBytesAllocated += size;
+        detail::TrackFree(m_MemoryTag, static_cast<int64_t>(m_CurrentSize));
+        detail::TrackAllocation(m_MemoryTag, static_cast<int64_t>(size));
+        m_CurrentSize = size;
+    }
+
     void Buffer::clear(GLenum internalFormat, GLenum format, GLenum type, const void *data) {
+        GLW_CAPTURE(BufferClear, m_Buffer, size_t(0), m_CurrentSize, internalFormat, format, type, detail::CaptureBlob{data, detail::GetClearValueSize(format, type)});
+        detail::t_FrameStats.bufferClears++;
         glClearNamedBufferData(m_Buffer, internalFormat, format, type, data);
     }
 
     void Buffer::clear(size_t offset, size_t size, GLenum internalFormat, GLenum format, GLenum type, const void *data) {
+        GLW_VALIDATE(InRange({offset, size}, m_CurrentSize), "range [{}, {}) exceeds buffer {} of size {}", offset, offset + size, m_Buffer, m_CurrentSize);
+        GLW_CAPTURE(BufferClear, m_Buffer, offset, size, internalFormat, format, type, detail::CaptureBlob{data, detail::GetClearValueSize(format, type)});
+
+        detail::t_FrameStats.bufferClears++;
         glClearNamedBufferSubData(m_Buffer, internalFormat, offset, size, format, type, data);
     }
 
@@ -132,6 +577,17 @@ namespace glw {
     }
 
     void Buffer::copyTo(Buffer *destination, const engine::range<size_t> &sourceRange, size_t destinationOffset) {
+        GLW_VALIDATE(InRange(sourceRange, m_CurrentSize), "source range [{}, {}) exceeds buffer {} of size {}", sourceRange.offset,
+                     sourceRange.offset + sourceRange.size, m_Buffer, m_CurrentSize);
+        GLW_VALIDATE(InRange({destinationOffset, sourceRange.size}, destination->m_CurrentSize), "destination range [{}, {}) exceeds buffer {} of size {}",
+                     destinationOffset, destinationOffset + sourceRange.size, destination->m_Buffer, destination->m_CurrentSize);
+        GLW_VALIDATE(destination != this || destinationOffset >= sourceRange.offset + sourceRange.size || sourceRange.offset >= destinationOffset + sourceRange.size,
+                     "source and destination ranges overlap in buffer {}", m_Buffer);
+        GLW_CAPTURE(BufferCopy, m_Buffer, destination->m_Buffer, sourceRange.offset, destinationOffset, sourceRange.size);
+        InsertPendingBarriers(BarrierBit::BufferUpdate);
+
+        detail::t_FrameStats.bufferCopies++;
+        detail::t_FrameStats.bufferBytesCopied += sourceRange.size;
         glCopyNamedBufferSubData(m_Buffer, destination->m_Buffer, sourceRange.offset, destinationOffset, sourceRange.size);
     }
 
@@ -160,6 +616,11 @@ namespace glw {
     }
 
     void Buffer::flushMappedRange(const engine::range<size_t> &range) const {
+        GLW_VALIDATE(m_Mapped && (m_MappedAccess & GL_MAP_FLUSH_EXPLICIT_BIT), "buffer {} is not mapped with GL_MAP_FLUSH_EXPLICIT_BIT", m_Buffer);
+        GLW_VALIDATE(InRange(range, m_MappedRange.size), "range [{}, {}) exceeds the mapped length {}", range.offset, range.offset + range.size, m_MappedRange.size);
+        GLW_CAPTURE(BufferWrite, m_Buffer, m_MappedRange.offset + range.offset, detail::CaptureBlob{static_cast<const uint8_t *>(m_MappedPointer) + range.offset, range.size});
+        GLW_CAPTURE(BufferFlush, m_Buffer, range.offset, range.size);
+
         glFlushMappedNamedBufferRange(m_Buffer, range.offset, range.size);
     }
 
@@ -200,28 +661,138 @@ namespace glw {
     }
 
     engine::cpu_memory Buffer::getSubData(const engine::range<size_t> &range) {
+        ENGINE_PROFILE_FUNCTION();
+        GLW_VALIDATE(InRange(range, m_CurrentSize), "range [{}, {}) exceeds buffer {} of size {}", range.offset, range.offset + range.size, m_Buffer, m_CurrentSize);
+        GLW_VALIDATE(!m_Mapped || (m_MappedAccess & GL_MAP_PERSISTENT_BIT), "buffer {} is mapped without GL_MAP_PERSISTENT_BIT", m_Buffer);
+
+        InsertPendingBarriers(BarrierBit::BufferUpdate);
+        detail::t_FrameStats.bufferReadbacks++;
+        detail::t_FrameStats.bufferBytesRead += range.size;
+
         auto mem = engine::cpu_memory(range.size);
         glGetNamedBufferSubData(m_Buffer, range.offset, range.size, mem.data);
         return mem;
     }
 
     void *Buffer::map(GLenum access) {
-        return glMapNamedBuffer(m_Buffer, access);
+        GLW_VALIDATE(!m_Mapped, "buffer {} is already mapped", m_Buffer);
+
+        GLW_CAPTURE(BufferMap, m_Buffer, access, false, size_t(0), m_CurrentSize);
+        InsertPendingBarriers(BarrierBit::BufferUpdate | BarrierBit::ClientMappedBuffer);
+
+        detail::t_FrameStats.bufferMaps++;
+        void *pointer = glMapNamedBuffer(m_Buffer, access);
+
+        // glMapNamedBuffer takes GL_READ_ONLY/GL_WRITE_ONLY/GL_READ_WRITE rather than access bits.
+        m_Mapped        = pointer != nullptr;
+        m_MappedPointer = pointer;
+        m_MappedRange   = {0, m_CurrentSize};
+        m_MappedAccess  = access == GL_READ_ONLY ? GL_MAP_READ_BIT : access == GL_WRITE_ONLY ? GL_MAP_WRITE_BIT : GL_MAP_READ_BIT | GL_MAP_WRITE_BIT;
+        return pointer;
     }
 
     void *Buffer::map(GLenum access, const engine::range<size_t> &range) {
-        return glMapNamedBufferRange(m_Buffer, range.offset, range.size, access);
+        GLW_VALIDATE(!m_Mapped, "buffer {} is already mapped", m_Buffer);
+        GLW_VALIDATE(InRange(range, m_CurrentSize), "range [{}, {}) exceeds buffer {} of size {}", range.offset, range.offset + range.size, m_Buffer, m_CurrentSize);
+
+        GLW_CAPTURE(BufferMap, m_Buffer, access, true, range.offset, range.size);
+        InsertPendingBarriers(BarrierBit::BufferUpdate | BarrierBit::ClientMappedBuffer);
+
+        detail::t_FrameStats.bufferMaps++;
+        void *pointer   = glMapNamedBufferRange(m_Buffer, range.offset, range.size, access);
+        m_Mapped        = pointer != nullptr;
+        m_MappedPointer = pointer;
+        m_MappedRange   = range;
+        m_MappedAccess  = access;
+        return pointer;
+    }
+
+    bool Buffer::unmap() {
+        GLW_VALIDATE(m_Mapped, "buffer {} is not mapped", m_Buffer);
+
+        // Whatever was written through a non-explicit mapping becomes visible now, so that is when it is captured.
+        if ((m_MappedAccess & GL_MAP_WRITE_BIT) && !(m_MappedAccess & GL_MAP_FLUSH_EXPLICIT_BIT))
+            GLW_CAPTURE(BufferWrite, m_Buffer, m_MappedRange.offset, detail::CaptureBlob{m_MappedPointer, m_MappedRange.size});
+        GLW_CAPTURE(BufferUnmap, m_Buffer);
+
+        m_Mapped        = false;
+        m_MappedPointer = nullptr;
+        m_MappedAccess  = 0;
+        return glUnmapNamedBuffer(m_Buffer) == GL_TRUE;
+    }
+
+    Query::Query(Query::Type type) : m_Type(type) {
+        glCreateQueries(static_cast<GLenum>(type), 1, &m_Query);
+    }
+
+    Query::~Query() {
+        glDeleteQueries(1, &m_Query);
+    }
+
+    void Query::begin() {
+        GLW_VALIDATE(m_Type != Type::Timestamp, "timestamp query {} must use counter()", m_Query);
+        glBeginQuery(static_cast<GLenum>(m_Type), m_Query);
+    }
+
+    void Query::end() {
+        glEndQuery(static_cast<GLenum>(m_Type));
+    }
+
+    void Query::counter() {
+        GLW_VALIDATE(m_Type == Type::Timestamp, "query {} is not a timestamp query", m_Query);
+        glQueryCounter(m_Query, GL_TIMESTAMP);
+    }
+
+    bool Query::isResultAvailable() const {
+        GLuint available;
+        glGetQueryObjectuiv(m_Query, GL_QUERY_RESULT_AVAILABLE, &available);
+        return available == GL_TRUE;
+    }
+
+    uint64_t Query::getResult() const {
+        GLuint64 result;
+        glGetQueryObjectui64v(m_Query, GL_QUERY_RESULT, &result);
+        return result;
+    }
+
+    void Query::writeResult(const Buffer *buffer, size_t offset) const {
+        GLW_VALIDATE(InRange({offset, sizeof(uint64_t)}, buffer->getCurrentSize()), "offset {} exceeds buffer {} of size {}", offset, buffer->getHandle(),
+                     buffer->getCurrentSize());
+        glGetQueryBufferObjectui64v(m_Query, buffer->getHandle(), GL_QUERY_RESULT, static_cast<GLintptr>(offset));
+    }
+
+    Fence::Fence() {
+        m_Sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    Fence::~Fence() {
+        glDeleteSync(m_Sync);
+    }
+
+    bool Fence::isSignaled() const {
+        GLint status;
+        glGetSynciv(m_Sync, GL_SYNC_STATUS, 1, nullptr, &status);
+        return status == GL_SIGNALED;
+    }
+
+    bool Fence::wait(uint64_t timeoutNanoseconds) const {
+        GLenum result = glClientWaitSync(m_Sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNanoseconds);
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
     }
 
     VertexArray::VertexArray() {
         glCreateVertexArrays(1, &m_VertexArray);
+        GLW_CAPTURE(VertexArrayCreate, m_VertexArray);
     }
 
     VertexArray::~VertexArray() {
+        GLW_CAPTURE(VertexArrayDelete, m_VertexArray);
         glDeleteVertexArrays(1, &m_VertexArray);
     }
 
     void VertexArray::bindVertexBuffer(const Buffer *buffer, const std::vector<size_t> &sizes, size_t offset) {
+        GLW_CAPTURE(VertexArrayVertexBuffer, m_VertexArray, buffer->getHandle(), offset, sizes);
+
         size_t stride = 0;
         unsigned int binding = m_NextBinding++;
 
@@ -237,6 +808,8 @@ namespace glw {
     }
 
     void VertexArray::bindVertexBuffer(const Buffer *buffer, const std::vector<Attribute> &attribs, size_t stride, size_t offset) {
+        GLW_CAPTURE(VertexArrayVertexBufferLayout, m_VertexArray, buffer->getHandle(), offset, stride, attribs);
+
         unsigned int binding = m_NextBinding++;
 
         for (const auto& a : attribs) {
@@ -249,32 +822,490 @@ namespace glw {
         glVertexArrayVertexBuffer(m_VertexArray, binding, buffer->getHandle(), offset, stride);
     }
 
+    void VertexArray::bindVertexBuffers(unsigned int first, std::span<const Buffer *const> buffers, std::span<const size_t> offsets, std::span<const int> strides) {
+        GLW_VALIDATE(buffers.size() == offsets.size() && buffers.size() == strides.size(), "{} buffers, {} offsets and {} strides", buffers.size(), offsets.size(),
+                     strides.size());
+        GLW_VALIDATE(first + buffers.size() <= m_NextBinding, "bindings [{}, {}) were not set up on vertex array {}", first, first + buffers.size(), m_VertexArray);
+
+        auto &handles = detail::t_BindHandles;
+        auto &ranges  = detail::t_BindOffsets;
+        handles.clear();
+        ranges.clear();
+        for (size_t i = 0; i < buffers.size(); i++) {
+            handles.push_back(buffers[i] ? buffers[i]->getHandle() : 0);
+            ranges.push_back(static_cast<GLintptr>(offsets[i]));
+        }
+        GLW_CAPTURE(VertexArrayVertexBuffers, m_VertexArray, first, handles, std::vector<size_t>(offsets.begin(), offsets.end()), std::vector<int>(strides.begin(), strides.end()));
+
+        glVertexArrayVertexBuffers(m_VertexArray, first, static_cast<GLsizei>(handles.size()), handles.data(), ranges.data(), strides.data());
+    }
+
     void VertexArray::bindElementBuffer(const Buffer *buffer) {
+        GLW_CAPTURE(VertexArrayElementBuffer, m_VertexArray, buffer->getHandle());
         glVertexArrayElementBuffer(m_VertexArray, buffer->getHandle());
         m_ElementBufferBound = true;
     }
 
     void VertexArray::bind() const {
+        GLW_CAPTURE(VertexArrayBind, m_VertexArray);
+        detail::t_FrameStats.vertexArrayBinds++;
         glBindVertexArray(m_VertexArray);
     }
 
-    GenericTexture::GenericTexture(GenericTexture::Type type) {
+    GenericTexture::GenericTexture(GenericTexture::Type type) : m_Type(type) {
         glCreateTextures(static_cast<GLenum>(type), 1, &m_Texture);
+        GLW_CAPTURE(TextureCreate, m_Texture, static_cast<GLenum>(type));
     }
 
     GenericTexture::~GenericTexture() {
+        GLW_CAPTURE(TextureDelete, m_Texture);
+        detail::TrackFree(m_MemoryTag, static_cast<int64_t>(m_MemorySize));
         glDeleteTextures(1, &m_Texture);
     }
 
+    void GenericTexture::storage1D(int levels, InternalFormat format, int width) {
+        GLW_CAPTURE(TextureStorage1D, m_Texture, levels, format, width);
+
+        m_InternalFormat = format;
+        m_Width          = width;
+        m_Height         = 1;
+        m_Depth          = 1;
+        glTextureStorage1D(m_Texture, levels, static_cast<GLenum>(format), width);
+        trackStorage(levels, 1);
+    }
+
+    void GenericTexture::storage2D(int levels, InternalFormat format, int width, int height) {
+        GLW_CAPTURE(TextureStorage2D, m_Texture, levels, format, width, height);
+
+        m_InternalFormat = format;
+        m_Width          = width;
+        m_Height         = height;
+        m_Depth          = 1;
+        glTextureStorage2D(m_Texture, levels, static_cast<GLenum>(format), width, height);
+        trackStorage(levels, 1);
+    }
+
+    void GenericTexture::storage3D(int levels, InternalFormat format, int width, int height, int depth) {
+        GLW_CAPTURE(TextureStorage3D, m_Texture, levels, format, width, height, depth);
+
+        m_InternalFormat = format;
+        m_Width          = width;
+        m_Height         = height;
+        m_Depth          = depth;
+        glTextureStorage3D(m_Texture, levels, static_cast<GLenum>(format), width, height, depth);
+        trackStorage(levels, 1);
+    }
+
+    void GenericTexture::storage2DMultisample(int samples, InternalFormat format, int width, int height, bool fixedSampleLocations) {
+        GLW_CAPTURE(TextureStorage2DMultisample, m_Texture, samples, format, width, height, fixedSampleLocations);
+
+        m_InternalFormat = format;
+        m_Width          = width;
+        m_Height         = height;
+        m_Depth          = 1;
+        glTextureStorage2DMultisample(m_Texture, samples, static_cast<GLenum>(format), width, height, fixedSampleLocations);
+        trackStorage(1, samples);
+    }
+
+    void GenericTexture::setMemoryTag(MemoryTag tag) {
+        detail::TrackTransfer(m_MemoryTag, tag, static_cast<int64_t>(m_MemorySize));
+        m_MemoryTag = tag;
+    }
+
+    void GenericTexture::trackStorage(int levels, int samples) {
+        // 1D arrays keep their layer count in height, 2D/cubemap arrays in depth; neither shrinks with the mip chain.
+        bool shrinkHeight = m_Type != Type::Texture1DArray;
+        bool shrinkDepth  = m_Type == Type::Texture3D;
+        uint64_t faces    = m_Type == Type::TextureCubemap ? 6 : 1;
+
+        uint64_t size = 0;
+        for (int level = 0; level < levels; level++) {
+            uint64_t width  = std::max(m_Width >> level, 1);
+            uint64_t height = shrinkHeight ? std::max(m_Height >> level, 1) : m_Height;
+            uint64_t depth  = shrinkDepth ? std::max(m_Depth >> level, 1) : m_Depth;
+            size += GetImageSize(m_InternalFormat, width, height, depth);
+        }
+        size *= faces * static_cast<uint64_t>(samples);
+
+        detail::TrackFree(m_MemoryTag, static_cast<int64_t>(m_MemorySize));
+        detail::TrackAllocation(m_MemoryTag, static_cast<int64_t>(size));
+        m_Levels     = levels;
+        m_MemorySize = size;
+    }
+
     void GenericTexture::bind(GLenum type) const {
+        GLW_CAPTURE(TextureBind, m_Texture, type);
+        detail::t_FrameStats.textureBinds++;
         glBindTexture(type, m_Texture);
     }
 
     void GenericTexture::bind(GenericTexture::Type type) const {
+        GLW_VALIDATE(type == m_Type, "texture {} of type 0x{:X} bound as 0x{:X}", m_Texture, static_cast<GLenum>(m_Type), static_cast<GLenum>(type));
         bind(static_cast<GLenum>(type));
     }
 
-    void GenericTexture::setActiveTextureUnit(uint8_t n) {
+    void GenericTexture::bindUnit(unsigned int unit) const {
+        GLW_CAPTURE(TextureBindUnit, m_Texture, unit);
+        detail::t_FrameStats.textureBinds++;
+        glBindTextureUnit(unit, m_Texture);
+    }
+
+    void GenericTexture::clear(int level, GLenum format, GLenum type, const void *data) {
+        GLW_VALIDATE(level >= 0 && level < m_Levels, "clear level {} out of range for texture {} with {} levels", level, m_Texture, m_Levels);
+        GLW_CAPTURE(TextureClear, m_Texture, level, format, type, detail::CaptureBlob{data, detail::GetClearValueSize(format, type)});
+        glClearTexImage(m_Texture, level, format, type, data);
+    }
+
+    void GenericTexture::setActiveTextureUnit(unsigned int n) {
         glActiveTexture(GL_TEXTURE0 + n);
     }
+
+    int GenericTexture::getImageLayers(int level) const {
+        switch (m_Type) {
+            case Type::Texture3D: return std::max(m_Depth >> level, 1);
+            case Type::Texture1DArray: return m_Height;
+            case Type::Texture2DArray:
+            case Type::Texture2DMSArray:
+            case Type::TextureCubemapArray: return m_Depth;
+            case Type::TextureCubemap: return 6;
+            default: return 1;
+        }
+    }
+
+    void GenericTexture::bindImage(unsigned int unit, int level, bool layered, int layer, AccessMode accessMode, GLenum format) const {
+        GLW_VALIDATE(m_Levels > 0, "texture {} has no immutable storage to bind as an image", m_Texture);
+        GLW_VALIDATE(level >= 0 && level < m_Levels, "image level {} out of range for texture {} with {} levels", level, m_Texture, m_Levels);
+        GLW_VALIDATE(layered || (layer >= 0 && layer < getImageLayers(level)), "image layer {} out of range for texture {} with {} layers", layer, m_Texture,
+                     getImageLayers(level));
+
+        GLW_CAPTURE(TextureBindImage, m_Texture, unit, level, layered, layer, static_cast<GLenum>(accessMode), format);
+        detail::t_FrameStats.textureBinds++;
+        glBindImageTexture(unit, m_Texture, level, layered ? GL_TRUE : GL_FALSE, layer, static_cast<GLenum>(accessMode), format);
+    }
+
+    void GenericTexture::bindImage(unsigned int unit, int level, bool layered, int layer, AccessMode accessMode, ImageFormat format) const {
+        GLW_VALIDATE(IsImageCompatible(m_InternalFormat, format), "texture {} of format 0x{:X} cannot be bound as image format 0x{:X}", m_Texture,
+                     static_cast<GLenum>(m_InternalFormat), static_cast<GLenum>(format));
+        bindImage(unit, level, layered, layer, accessMode, static_cast<GLenum>(format));
+    }
+
+    void GenericTexture::bindImage(unsigned int unit, AccessMode accessMode, int level) const {
+        GLW_VALIDATE(IsImageFormat(m_InternalFormat), "texture {} of format 0x{:X} has no image format", m_Texture, static_cast<GLenum>(m_InternalFormat));
+        bool layered = getImageLayers(level) > 1 || m_Type == Type::Texture1DArray || m_Type == Type::Texture2DArray;
+        bindImage(unit, level, layered, 0, accessMode, static_cast<GLenum>(m_InternalFormat));
+    }
+
+    void InsertMemoryBarrier(BarrierBit barriers) {
+        GLW_CAPTURE(InsertMemoryBarrier, static_cast<GLbitfield>(barriers), false);
+        detail::t_FrameStats.memoryBarriers++;
+        detail::t_PendingBarriers = static_cast<BarrierBit>(static_cast<GLbitfield>(detail::t_PendingBarriers) & ~static_cast<GLbitfield>(barriers));
+        glMemoryBarrier(static_cast<GLbitfield>(barriers));
+    }
+
+    void InsertMemoryBarrierByRegion(BarrierBit barriers) {
+        GLW_CAPTURE(InsertMemoryBarrier, static_cast<GLbitfield>(barriers), true);
+        detail::t_FrameStats.memoryBarriers++;
+        glMemoryBarrierByRegion(static_cast<GLbitfield>(barriers));
+    }
+
+    void InsertPendingBarriers(BarrierBit consumers) {
+        auto needed = detail::t_PendingBarriers & consumers;
+        if (needed != BarrierBit{})
+            InsertMemoryBarrier(needed);
+    }
+
+    void BindBuffersBase(Buffer::Target target, unsigned int first, std::span<const Buffer *const> buffers) {
+        GLW_VALIDATE(IsIndexedTarget(static_cast<GLenum>(target)), "target 0x{:X} is not an indexed buffer target", static_cast<GLenum>(target));
+
+        auto &handles = detail::t_BindHandles;
+        handles.clear();
+        for (const auto *buffer : buffers) handles.push_back(buffer ? buffer->getHandle() : 0);
+        GLW_CAPTURE(BufferBindBases, static_cast<GLenum>(target), first, handles);
+
+        detail::t_FrameStats.bufferBinds++;
+        glBindBuffersBase(static_cast<GLenum>(target), first, static_cast<GLsizei>(handles.size()), handles.data());
+    }
+
+    void BindBuffersRange(Buffer::Target target, unsigned int first, std::span<const Buffer *const> buffers, std::span<const engine::range<size_t>> ranges) {
+        GLW_VALIDATE(IsIndexedTarget(static_cast<GLenum>(target)), "target 0x{:X} is not an indexed buffer target", static_cast<GLenum>(target));
+        GLW_VALIDATE(buffers.size() == ranges.size(), "{} buffers but {} ranges", buffers.size(), ranges.size());
+
+        auto &handles = detail::t_BindHandles;
+        auto &offsets = detail::t_BindOffsets;
+        auto &sizes   = detail::t_BindSizes;
+        handles.clear();
+        offsets.clear();
+        sizes.clear();
+        for (size_t i = 0; i < buffers.size(); i++) {
+            GLW_VALIDATE(!buffers[i] || InRange(ranges[i], buffers[i]->getCurrentSize()), "range [{}, {}) exceeds buffer {} of size {}", ranges[i].offset,
+                         ranges[i].offset + ranges[i].size, buffers[i]->getHandle(), buffers[i]->getCurrentSize());
+            GLW_VALIDATE(target != Buffer::Target::Uniform || ranges[i].offset % GetCapabilities().uniformBufferOffsetAlignment == 0,
+                         "offset {} is not a multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT", ranges[i].offset);
+            GLW_VALIDATE(target != Buffer::Target::ShaderStorage || ranges[i].offset % GetCapabilities().shaderStorageBufferOffsetAlignment == 0,
+                         "offset {} is not a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT", ranges[i].offset);
+
+            // Null slots ignore their range, but some drivers still reject a zero size.
+            handles.push_back(buffers[i] ? buffers[i]->getHandle() : 0);
+            offsets.push_back(buffers[i] ? static_cast<GLintptr>(ranges[i].offset) : 0);
+            sizes.push_back(buffers[i] ? static_cast<GLsizeiptr>(ranges[i].size) : 1);
+        }
+        GLW_CAPTURE(BufferBindRanges, static_cast<GLenum>(target), first, handles, std::vector<engine::range<size_t>>(ranges.begin(), ranges.end()));
+
+        detail::t_FrameStats.bufferBinds++;
+        glBindBuffersRange(static_cast<GLenum>(target), first, static_cast<GLsizei>(handles.size()), handles.data(), offsets.data(), sizes.data());
+    }
+
+    void BindTextures(unsigned int first, std::span<const GenericTexture *const> textures) {
+        auto &handles = detail::t_BindHandles;
+        handles.clear();
+        for (const auto *texture : textures) handles.push_back(texture ? texture->getHandle() : 0);
+        GLW_CAPTURE(TextureBindUnits, first, handles);
+
+        detail::t_FrameStats.textureBinds++;
+        glBindTextures(first, static_cast<GLsizei>(handles.size()), handles.data());
+    }
+
+    void BindImageTextures(unsigned int first, std::span<const GenericTexture *const> textures) {
+        auto &handles = detail::t_BindHandles;
+        handles.clear();
+        for (const auto *texture : textures) {
+            GLW_VALIDATE(!texture || texture->getLevels() > 0, "texture {} has no immutable storage to bind as an image", texture->getHandle());
+            handles.push_back(texture ? texture->getHandle() : 0);
+        }
+        GLW_CAPTURE(TextureBindImageUnits, first, handles);
+
+        detail::t_FrameStats.textureBinds++;
+        glBindImageTextures(first, static_cast<GLsizei>(handles.size()), handles.data());
+    }
+
+    Shader::Shader(Shader::Type type) : m_Type(type) {
+        m_Shader = glCreateShader(static_cast<GLenum>(type));
+        GLW_CAPTURE(ShaderCreate, m_Shader, static_cast<GLenum>(type));
+    }
+
+    Shader::~Shader() {
+        GLW_CAPTURE(ShaderDelete, m_Shader);
+        glDeleteShader(m_Shader);
+    }
+
+    std::unique_ptr<Shader> Shader::fromSource(Shader::Type type, const std::string &source) {
+        auto shader = std::make_unique<Shader>(type);
+        shader->source(source);
+        shader->compile();
+        return shader;
+    }
+
+    std::unique_ptr<Shader> Shader::fromSpirV(Shader::Type type, const std::vector<uint32_t> &binary, const std::string &entryPoint,
+                                              const std::vector<SpecializationConstant> &constants) {
+        auto shader = std::make_unique<Shader>(type);
+        shader->binary(binary);
+        shader->specialize(entryPoint, constants);
+        return shader;
+    }
+
+    void Shader::source(const std::string &source) {
+        GLW_CAPTURE(ShaderSource, m_Shader, source);
+
+        const char *str = source.c_str();
+        auto        len = static_cast<GLint>(source.size());
+        glShaderSource(m_Shader, 1, &str, &len);
+    }
+
+    void Shader::compile() {
+        ENGINE_PROFILE_FUNCTION();
+        GLW_CAPTURE(ShaderCompile, m_Shader);
+
+        glCompileShader(m_Shader);
+        if (!isCompiled())
+            throw std::runtime_error("Failed to compile shader: " + getInfoLog());
+    }
+
+    void Shader::binary(const std::vector<uint32_t> &spirv) {
+        if (!IsSpirVSupported())
+            throw std::runtime_error("SPIR-V shaders are not supported by this context");
+
+        const auto &supported = GetSpirVExtensions();
+        for (const auto &ext : GetSpirVModuleExtensions(spirv)) {
+            if (std::find(supported.begin(), supported.end(), ext) == supported.end())
+                throw std::runtime_error("SPIR-V module requires unsupported extension '" + ext + "'");
+        }
+
+        GLW_CAPTURE(ShaderBinary, m_Shader, spirv);
+        glShaderBinary(1, &m_Shader, GL_SHADER_BINARY_FORMAT_SPIR_V, spirv.data(), static_cast<GLsizei>(spirv.size() * sizeof(uint32_t)));
+    }
+
+    void Shader::specialize(const std::string &entryPoint, const std::vector<SpecializationConstant> &constants) {
+        ENGINE_PROFILE_FUNCTION();
+        GLW_CAPTURE(ShaderSpecialize, m_Shader, entryPoint, constants);
+
+        std::vector<GLuint> indices;
+        std::vector<GLuint> values;
+        indices.reserve(constants.size());
+        values.reserve(constants.size());
+        for (const auto &c : constants) {
+            indices.push_back(c.index);
+            values.push_back(c.value);
+        }
+
+        glSpecializeShader(m_Shader, entryPoint.c_str(), static_cast<GLuint>(constants.size()), indices.data(), values.data());
+        if (!isCompiled())
+            throw std::runtime_error("Failed to specialize SPIR-V shader: " + getInfoLog());
+    }
+
+    bool Shader::isCompiled() const {
+        int b;
+        glGetShaderiv(m_Shader, GL_COMPILE_STATUS, &b);
+        return b == GL_TRUE;
+    }
+
+    std::string Shader::getInfoLog() const {
+        int length;
+        glGetShaderiv(m_Shader, GL_INFO_LOG_LENGTH, &length);
+        if (length <= 0)
+            return {};
+
+        std::string log(length, '\0');
+        glGetShaderInfoLog(m_Shader, length, nullptr, log.data());
+        log.resize(length - 1);
+        return log;
+    }
+
+    Program::Program() {
+        m_Program = glCreateProgram();
+        GLW_CAPTURE(ProgramCreate, m_Program);
+    }
+
+    Program::~Program() {
+        GLW_CAPTURE(ProgramDelete, m_Program);
+        glDeleteProgram(m_Program);
+    }
+
+    std::shared_ptr<Program> Program::create(const std::vector<ShaderSource> &sources) {
+        ENGINE_PROFILE_FUNCTION();
+
+        std::vector<std::unique_ptr<Shader>> shaders;
+        shaders.reserve(sources.size());
+        for (const auto &s : sources) {
+            shaders.push_back(Shader::fromSource(s.stage, s.source));
+        }
+
+        auto program = std::make_shared<Program>();
+        for (const auto &shader : shaders) program->attach(shader.get());
+        program->link();
+        for (const auto &shader : shaders) program->detach(shader.get());
+
+        return program;
+    }
+
+    std::shared_ptr<Program> Program::createFromSpirV(const std::vector<SpirVModule> &modules) {
+        ENGINE_PROFILE_FUNCTION();
+
+        std::vector<std::unique_ptr<Shader>> shaders;
+        shaders.reserve(modules.size());
+        for (const auto &m : modules) {
+            shaders.push_back(Shader::fromSpirV(m.stage, m.binary, m.entryPoint, m.constants));
+        }
+
+        auto program = std::make_shared<Program>();
+        for (const auto &shader : shaders) program->attach(shader.get());
+        program->link();
+        for (const auto &shader : shaders) program->detach(shader.get());
+
+        return program;
+    }
+
+    std::shared_ptr<Program> Program::createAsync(const std::vector<ShaderSource> &sources) {
+        auto program = std::make_shared<Program>();
+        program->m_PendingShaders.reserve(sources.size());
+        for (const auto &s : sources) {
+            auto shader = std::make_unique<Shader>(s.stage);
+            shader->source(s.source);
+            GLW_CAPTURE(ShaderCompile, shader->getHandle());
+            glCompileShader(shader->getHandle());
+            program->attach(shader.get());
+            program->m_PendingShaders.push_back(std::move(shader));
+        }
+
+        GLW_CAPTURE(ProgramLink, program->m_Program);
+        glLinkProgram(program->m_Program);
+        return program;
+    }
+
+    bool Program::isReady() const {
+        return detail::g_Backend.isProgramLinkComplete(m_Program);
+    }
+
+    void Program::finish() {
+        ENGINE_PROFILE_FUNCTION();
+
+        if (m_PendingShaders.empty())
+            return;
+
+        auto shaders = std::move(m_PendingShaders);
+        for (const auto &shader : shaders) {
+            if (!shader->isCompiled())
+                throw std::runtime_error("Failed to compile shader: " + shader->getInfoLog());
+        }
+
+        if (!isLinked())
+            throw std::runtime_error("Failed to link program: " + getInfoLog());
+
+        for (const auto &shader : shaders) detach(shader.get());
+        m_Reflection = ProgramReflection(m_Program);
+    }
+
+    void Program::attach(const Shader *shader) {
+        GLW_CAPTURE(ProgramAttach, m_Program, shader->getHandle());
+        glAttachShader(m_Program, shader->getHandle());
+    }
+
+    void Program::detach(const Shader *shader) {
+        GLW_CAPTURE(ProgramDetach, m_Program, shader->getHandle());
+        glDetachShader(m_Program, shader->getHandle());
+    }
+
+    void Program::link() {
+        ENGINE_PROFILE_FUNCTION();
+        GLW_CAPTURE(ProgramLink, m_Program);
+
+        glLinkProgram(m_Program);
+        if (!isLinked())
+            throw std::runtime_error("Failed to link program: " + getInfoLog());
+
+        m_Reflection = ProgramReflection(m_Program);
+    }
+
+    void Program::use() const {
+        GLW_CAPTURE(ProgramUse, m_Program);
+        detail::t_FrameStats.programBinds++;
+        glUseProgram(m_Program);
+    }
+
+    void Program::resolveBindingConflicts() {
+        GLW_CAPTURE(ProgramResolveBindings, m_Program);
+        m_Reflection.resolveConflicts(m_Program);
+    }
+
+    void Program::setUniform(int location, uint32_t value) const {
+        GLW_CAPTURE(ProgramUniform1ui, m_Program, location, value);
+        glProgramUniform1ui(m_Program, location, value);
+    }
+
+    bool Program::isLinked() const {
+        int b;
+        glGetProgramiv(m_Program, GL_LINK_STATUS, &b);
+        return b == GL_TRUE;
+    }
+
+    std::string Program::getInfoLog() const {
+        int length;
+        glGetProgramiv(m_Program, GL_INFO_LOG_LENGTH, &length);
+        if (length <= 0)
+            return {};
+
+        std::string log(length, '\0');
+        glGetProgramInfoLog(m_Program, length, nullptr, log.data());
+        log.resize(length - 1);
+        return log;
+    }
 }
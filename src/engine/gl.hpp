@@ -6,14 +6,136 @@
 #include <array>
 #include <string>
 #include <memory>
+#include <span>
+#include <bit>
+#include <bitset>
+#include <utility>
 
 #include "engine/engine.hpp"
+#include "engine/gl_capture.hpp"
+#include "engine/gl_reflection.hpp"
+#include "engine/gl_validation.hpp"
+#include "engine/gpu_memory.hpp"
 
 namespace glw {
+    enum class Extension : uint32_t {
+        ARB_buffer_storage,
+        ARB_clip_control,
+        ARB_compute_shader,
+        ARB_direct_state_access,
+        ARB_gl_spirv,
+        ARB_indirect_parameters,
+        ARB_invalidate_subdata,
+        ARB_multi_bind,
+        ARB_multi_draw_indirect,
+        ARB_parallel_shader_compile,
+        ARB_pipeline_statistics_query,
+        ARB_program_interface_query,
+        ARB_query_buffer_object,
+        ARB_sampler_objects,
+        ARB_shader_draw_parameters,
+        ARB_shader_image_load_store,
+        ARB_shader_storage_buffer_object,
+        ARB_sparse_buffer,
+        ARB_sparse_texture,
+        ARB_spirv_extensions,
+        ARB_texture_filter_anisotropic,
+        ARB_timer_query,
+        ARB_bindless_texture,
+        ATI_meminfo,
+        EXT_texture_filter_anisotropic,
+        KHR_debug,
+        KHR_no_error,
+        KHR_parallel_shader_compile,
+        NVX_gpu_memory_info,
+        Count,
+    };
+
+    struct Capabilities {
+        int versionMajor = 0;
+        int versionMinor = 0;
+
+        std::string version;
+        std::string vendor;
+        std::string renderer;
+        std::string shadingLanguageVersion;
+
+        std::vector<std::string> extensions;
+        std::vector<std::string> spirvExtensions;
+
+        std::bitset<static_cast<size_t>(Extension::Count)> extensionBits;
+
+        int                uniformBufferOffsetAlignment       = 0;
+        int                shaderStorageBufferOffsetAlignment = 0;
+        int                textureBufferOffsetAlignment       = 0;
+        int                minMapBufferAlignment              = 0;
+        int                maxUniformBlockSize                = 0;
+        int64_t            maxShaderStorageBlockSize          = 0;
+        int                maxUniformBufferBindings           = 0;
+        int                maxShaderStorageBufferBindings     = 0;
+        int                maxAtomicCounterBufferBindings     = 0;
+        int                maxCombinedTextureImageUnits       = 0;
+        int                maxImageUnits                      = 0;
+        int                maxVertexAttribs                   = 0;
+        int                maxVertexAttribBindings            = 0;
+        int                maxTextureSize                     = 0;
+        int                max3DTextureSize                   = 0;
+        int                maxArrayTextureLayers              = 0;
+        int                maxSamples                         = 0;
+        int                maxColorAttachments                = 0;
+        int                maxDrawBuffers                     = 0;
+        std::array<int, 3> maxComputeWorkGroupCount           = {};
+        std::array<int, 3> maxComputeWorkGroupSize            = {};
+        int                maxComputeWorkGroupInvocations     = 0;
+        int                maxComputeSharedMemorySize         = 0;
+        float              maxTextureMaxAnisotropy            = 1.0f;
+        int                timestampBits                      = 0;
+
+        [[nodiscard]] inline bool has(Extension ext) const noexcept { return extensionBits.test(static_cast<size_t>(ext)); };
+
+        [[nodiscard]] inline bool hasVersion(int major, int minor) const noexcept {
+            return versionMajor > major || (versionMajor == major && versionMinor >= minor);
+        };
+    };
+
+    namespace detail {
+        // Implementations picked once in load() from the Capabilities snapshot. Hot wrappers call straight
+        // through these pointers instead of re-checking capabilities on every call.
+        struct Backend {
+            void (*replaceBufferData)(GLuint buffer, GLsizeiptr size, const void* data, GLenum usage);
+
+            void (*multiDrawArraysIndirectCount)(GLenum mode, const void* indirect, GLintptr drawCount, GLsizei maxDrawCount, GLsizei stride);
+            void (*multiDrawElementsIndirectCount)(GLenum mode, GLenum type, const void* indirect, GLintptr drawCount, GLsizei maxDrawCount, GLsizei stride);
+
+            bool (*isShaderCompileComplete)(GLuint shader);
+            bool (*isProgramLinkComplete)(GLuint program);
+
+            const char* replaceBufferDataName;
+            const char* multiDrawIndirectCountName;
+            const char* shaderCompileName;
+        };
+
+        extern Backend g_Backend;
+    }
+
+    using ProcLoader = GLADloadfunc;
+
+    // Loads GL entry points through glfwGetProcAddress; the GLFW context must be current.
     void load();
+    void load(ProcLoader loader);
+
+    const Capabilities& GetCapabilities();
+
+    inline const detail::Backend& GetBackend() {
+        return detail::g_Backend;
+    };
+
+    inline bool HasExtension(Extension ext) {
+        return GetCapabilities().has(ext);
+    };
 
-    std::vector<std::string> GetExtensions();
-    std::vector<std::string> GetSpirVExtensions();
+    const std::vector<std::string>& GetExtensions();
+    const std::vector<std::string>& GetSpirVExtensions();
 
     int GetInteger(GLenum pname);
 
@@ -30,6 +152,165 @@ namespace glw {
     std::string GetString(GLenum pname);
     std::string GetStringi(GLenum pname, GLuint i);
 
+    struct FrameStats {
+        uint64_t drawCalls            = 0;
+        uint64_t indirectDrawCalls    = 0;
+        uint64_t dispatches           = 0;
+        uint64_t programBinds         = 0;
+        uint64_t pipelineBinds        = 0;
+        uint64_t stateChanges         = 0;
+        uint64_t memoryBarriers       = 0;
+        uint64_t vertexArrayBinds     = 0;
+        uint64_t bufferBinds          = 0;
+        uint64_t textureBinds         = 0;
+        uint64_t samplerBinds         = 0;
+        uint64_t bufferUploads        = 0;
+        uint64_t bufferBytesUploaded  = 0;
+        uint64_t bufferAllocations    = 0;
+        uint64_t bufferBytesAllocated = 0;
+        uint64_t bufferCopies         = 0;
+        uint64_t bufferBytesCopied    = 0;
+        uint64_t bufferClears         = 0;
+        uint64_t bufferMaps           = 0;
+        uint64_t bufferReadbacks      = 0;
+        uint64_t bufferBytesRead      = 0;
+    };
+
+    inline constexpr std::array<std::pair<const char*, uint64_t FrameStats::*>, 21> FrameStatsFields = {{
+        {"draw calls", &FrameStats::drawCalls},
+        {"indirect draw calls", &FrameStats::indirectDrawCalls},
+        {"dispatches", &FrameStats::dispatches},
+        {"program binds", &FrameStats::programBinds},
+        {"pipeline binds", &FrameStats::pipelineBinds},
+        {"state changes", &FrameStats::stateChanges},
+        {"memory barriers", &FrameStats::memoryBarriers},
+        {"vertex array binds", &FrameStats::vertexArrayBinds},
+        {"buffer binds", &FrameStats::bufferBinds},
+        {"texture binds", &FrameStats::textureBinds},
+        {"sampler binds", &FrameStats::samplerBinds},
+        {"buffer uploads", &FrameStats::bufferUploads},
+        {"buffer bytes uploaded", &FrameStats::bufferBytesUploaded},
+        {"buffer allocations", &FrameStats::bufferAllocations},
+        {"buffer bytes allocated", &FrameStats::bufferBytesAllocated},
+        {"buffer copies", &FrameStats::bufferCopies},
+        {"buffer bytes copied", &FrameStats::bufferBytesCopied},
+        {"buffer clears", &FrameStats::bufferClears},
+        {"buffer maps", &FrameStats::bufferMaps},
+        {"buffer readbacks", &FrameStats::bufferReadbacks},
+        {"buffer bytes read", &FrameStats::bufferBytesRead},
+    }};
+
+    namespace detail {
+        inline thread_local FrameStats t_FrameStats;
+        inline thread_local FrameStats t_LastFrameStats;
+    }
+
+    // Counters for the calling thread's current frame. ResetFrameStats() closes the frame: the counters move to
+    // GetLastFrameStats() and start again from zero.
+    inline FrameStats& GetFrameStats() {
+        return detail::t_FrameStats;
+    };
+
+    inline const FrameStats& GetLastFrameStats() {
+        return detail::t_LastFrameStats;
+    };
+
+    void ResetFrameStats();
+    void LogFrameStats(const FrameStats& stats);
+
+    // Each bit makes incoherent writes (image stores, SSBO writes, atomic counters) visible to one kind of later access.
+    enum class BarrierBit : GLbitfield {
+        VertexAttribArray = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+        ElementArray = GL_ELEMENT_ARRAY_BARRIER_BIT,
+        Uniform = GL_UNIFORM_BARRIER_BIT,
+        TextureFetch = GL_TEXTURE_FETCH_BARRIER_BIT,
+        ShaderImageAccess = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+        Command = GL_COMMAND_BARRIER_BIT,
+        PixelBuffer = GL_PIXEL_BUFFER_BARRIER_BIT,
+        TextureUpdate = GL_TEXTURE_UPDATE_BARRIER_BIT,
+        BufferUpdate = GL_BUFFER_UPDATE_BARRIER_BIT,
+        ClientMappedBuffer = GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT,
+        Framebuffer = GL_FRAMEBUFFER_BARRIER_BIT,
+        TransformFeedback = GL_TRANSFORM_FEEDBACK_BARRIER_BIT,
+        AtomicCounter = GL_ATOMIC_COUNTER_BARRIER_BIT,
+        ShaderStorage = GL_SHADER_STORAGE_BARRIER_BIT,
+        QueryBuffer = GL_QUERY_BUFFER_BARRIER_BIT,
+        All = GL_ALL_BARRIER_BITS,
+    };
+
+    constexpr BarrierBit operator|(BarrierBit a, BarrierBit b) {
+        return static_cast<BarrierBit>(static_cast<GLbitfield>(a) | static_cast<GLbitfield>(b));
+    }
+
+    constexpr BarrierBit operator&(BarrierBit a, BarrierBit b) {
+        return static_cast<BarrierBit>(static_cast<GLbitfield>(a) & static_cast<GLbitfield>(b));
+    }
+
+    // Clears the covered bits from the pending set tracked by MarkPendingWrites().
+    void InsertMemoryBarrier(BarrierBit barriers);
+
+    // Only orders fragment shader accesses within the same framebuffer region; cheaper on tiled GPUs.
+    void InsertMemoryBarrierByRegion(BarrierBit barriers);
+
+    // Barrier bits every consumer of a shader storage / image store write may need.
+    inline constexpr BarrierBit BufferWriteConsumers = BarrierBit::VertexAttribArray | BarrierBit::ElementArray | BarrierBit::Uniform | BarrierBit::TextureFetch |
+                                                      BarrierBit::Command | BarrierBit::PixelBuffer | BarrierBit::BufferUpdate | BarrierBit::ClientMappedBuffer |
+                                                      BarrierBit::TransformFeedback | BarrierBit::AtomicCounter | BarrierBit::ShaderStorage | BarrierBit::QueryBuffer;
+    inline constexpr BarrierBit ImageWriteConsumers = BarrierBit::ShaderImageAccess | BarrierBit::TextureFetch | BarrierBit::TextureUpdate | BarrierBit::PixelBuffer |
+                                                     BarrierBit::Framebuffer;
+
+    namespace detail {
+        inline thread_local BarrierBit t_PendingBarriers{};
+    } // namespace detail
+
+    // Incoherent writes are recorded as the barrier bits their consumers would need. InsertPendingBarriers() then issues
+    // one barrier for just the pending bits a consumer needs, or nothing when those writes were already synchronized.
+    inline void MarkPendingWrites(BarrierBit consumers) {
+        detail::t_PendingBarriers = detail::t_PendingBarriers | consumers;
+    };
+
+    void InsertPendingBarriers(BarrierBit consumers);
+
+    [[nodiscard]] inline BarrierBit GetPendingBarriers() {
+        return detail::t_PendingBarriers;
+    };
+
+    // Draws insert the pending barriers for what they fetch themselves: vertex attributes, indices and, when indirect,
+    // the commands. Barriers for what their shaders read (uniforms, storage, textures, images) are the caller's, e.g.
+    // InsertPendingBarriers(BarrierBit::ShaderStorage) before binding buffers a compute pass wrote.
+    void DrawArrays(GLenum mode, int first, int count, int instanceCount = 1, unsigned int baseInstance = 0);
+    void DrawElements(GLenum mode, int count, GLenum type, size_t offset = 0, int instanceCount = 1, int baseVertex = 0, unsigned int baseInstance = 0);
+
+    void MultiDrawArraysIndirect(GLenum mode, size_t indirectOffset, int drawCount, int stride = 0);
+    void MultiDrawElementsIndirect(GLenum mode, GLenum type, size_t indirectOffset, int drawCount, int stride = 0);
+
+    // The draw count is read from the buffer bound to GL_PARAMETER_BUFFER at drawCountOffset. Without
+    // ARB_indirect_parameters all maxDrawCount commands are issued, so unused commands must have a zero instance count.
+    inline void MultiDrawArraysIndirectCount(GLenum mode, size_t indirectOffset, size_t drawCountOffset, int maxDrawCount, int stride = 0) {
+        GLW_CAPTURE(MultiDrawArraysIndirectCount, mode, indirectOffset, drawCountOffset, maxDrawCount, stride);
+        InsertPendingBarriers(BarrierBit::VertexAttribArray | BarrierBit::Command);
+        detail::t_FrameStats.indirectDrawCalls++;
+        detail::g_Backend.multiDrawArraysIndirectCount(mode, reinterpret_cast<const void*>(indirectOffset), static_cast<GLintptr>(drawCountOffset), maxDrawCount, stride);
+    };
+
+    inline void MultiDrawElementsIndirectCount(GLenum mode, GLenum type, size_t indirectOffset, size_t drawCountOffset, int maxDrawCount, int stride = 0) {
+        GLW_CAPTURE(MultiDrawElementsIndirectCount, mode, type, indirectOffset, drawCountOffset, maxDrawCount, stride);
+        InsertPendingBarriers(BarrierBit::VertexAttribArray | BarrierBit::ElementArray | BarrierBit::Command);
+        detail::t_FrameStats.indirectDrawCalls++;
+        detail::g_Backend.multiDrawElementsIndirectCount(mode, type, reinterpret_cast<const void*>(indirectOffset), static_cast<GLintptr>(drawCountOffset), maxDrawCount,
+                                                         stride);
+    };
+
+    void DispatchCompute(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1);
+
+    // Group counts are read from a DispatchIndirectCommand in the buffer bound to GL_DISPATCH_INDIRECT_BUFFER.
+    void DispatchComputeIndirect(size_t indirectOffset);
+
+    bool IsSpirVSupported();
+
+    std::vector<uint32_t> ReadSpirV(const std::string& path);
+    std::vector<std::string> GetSpirVModuleExtensions(const std::vector<uint32_t>& binary);
+
     enum class AccessMode : GLenum {
         ReadOnly = GL_READ_ONLY,
         WriteOnly = GL_WRITE_ONLY,
@@ -46,8 +327,172 @@ namespace glw {
         R16F = GL_R16F,
         RGBA32UI = GL_RGBA32UI,
         RGBA16UI = GL_RGBA16UI,
+        RGBA8UI = GL_RGBA8UI,
+        RG32UI = GL_RG32UI,
+        R32UI = GL_R32UI,
+        R32I = GL_R32I,
+        R8UI = GL_R8UI,
+        RGBA8 = GL_RGBA8,
+        RGBA8_SNORM = GL_RGBA8_SNORM,
+        SRGB8_ALPHA8 = GL_SRGB8_ALPHA8,
+        RGB10_A2 = GL_RGB10_A2,
+        RG8 = GL_RG8,
+        R8 = GL_R8,
+        DEPTH_COMPONENT16 = GL_DEPTH_COMPONENT16,
+        DEPTH_COMPONENT24 = GL_DEPTH_COMPONENT24,
+        DEPTH_COMPONENT32F = GL_DEPTH_COMPONENT32F,
+        DEPTH24_STENCIL8 = GL_DEPTH24_STENCIL8,
+        DEPTH32F_STENCIL8 = GL_DEPTH32F_STENCIL8,
+        STENCIL_INDEX8 = GL_STENCIL_INDEX8,
+        RGBA_S3TC_DXT1 = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+        RGBA_S3TC_DXT5 = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+        RED_RGTC1 = GL_COMPRESSED_RED_RGTC1,
+        RG_RGTC2 = GL_COMPRESSED_RG_RGTC2,
+        RGB_BPTC_UNSIGNED_FLOAT = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,
+        RGBA_BPTC_UNORM = GL_COMPRESSED_RGBA_BPTC_UNORM,
+        SRGB_ALPHA_BPTC_UNORM = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
+    };
+
+    [[nodiscard]] constexpr bool IsCompressed(InternalFormat format) {
+        switch (format) {
+            case InternalFormat::RGBA_S3TC_DXT1:
+            case InternalFormat::RGBA_S3TC_DXT5:
+            case InternalFormat::RED_RGTC1:
+            case InternalFormat::RG_RGTC2:
+            case InternalFormat::RGB_BPTC_UNSIGNED_FLOAT:
+            case InternalFormat::RGBA_BPTC_UNORM:
+            case InternalFormat::SRGB_ALPHA_BPTC_UNORM: return true;
+            default: return false;
+        }
+    }
+
+    // Bits per texel as drivers typically store them; 24-bit depth is padded to 32 and compressed formats report the
+    // average over their 4x4 block.
+    [[nodiscard]] constexpr unsigned int GetBitsPerPixel(InternalFormat format) {
+        switch (format) {
+            case InternalFormat::RGBA32F:
+            case InternalFormat::RGBA32UI: return 128;
+            case InternalFormat::RGBA16F:
+            case InternalFormat::RGBA16UI:
+            case InternalFormat::RG32F:
+            case InternalFormat::RG32UI:
+            case InternalFormat::DEPTH32F_STENCIL8: return 64;
+            case InternalFormat::RG16F:
+            case InternalFormat::R11F_G11F_B10F:
+            case InternalFormat::R32F:
+            case InternalFormat::R32UI:
+            case InternalFormat::R32I:
+            case InternalFormat::RGBA8UI:
+            case InternalFormat::RGBA8:
+            case InternalFormat::RGBA8_SNORM:
+            case InternalFormat::SRGB8_ALPHA8:
+            case InternalFormat::RGB10_A2:
+            case InternalFormat::DEPTH_COMPONENT24:
+            case InternalFormat::DEPTH_COMPONENT32F:
+            case InternalFormat::DEPTH24_STENCIL8: return 32;
+            case InternalFormat::R16F:
+            case InternalFormat::RG8:
+            case InternalFormat::DEPTH_COMPONENT16: return 16;
+            case InternalFormat::R8UI:
+            case InternalFormat::R8:
+            case InternalFormat::STENCIL_INDEX8:
+            case InternalFormat::RGBA_S3TC_DXT5:
+            case InternalFormat::RG_RGTC2:
+            case InternalFormat::RGB_BPTC_UNSIGNED_FLOAT:
+            case InternalFormat::RGBA_BPTC_UNORM:
+            case InternalFormat::SRGB_ALPHA_BPTC_UNORM: return 8;
+            case InternalFormat::RGBA_S3TC_DXT1:
+            case InternalFormat::RED_RGTC1: return 4;
+        }
+        return 0;
+    }
+
+    // The InternalFormat subset usable with image load/store, i.e. the formats GLSL accepts as image layout qualifiers.
+    enum class ImageFormat : GLenum {
+        RGBA32F = static_cast<GLenum>(InternalFormat::RGBA32F),
+        RGBA16F = static_cast<GLenum>(InternalFormat::RGBA16F),
+        RG32F = static_cast<GLenum>(InternalFormat::RG32F),
+        RG16F = static_cast<GLenum>(InternalFormat::RG16F),
+        R11F_G11F_B10F = static_cast<GLenum>(InternalFormat::R11F_G11F_B10F),
+        R32F = static_cast<GLenum>(InternalFormat::R32F),
+        R16F = static_cast<GLenum>(InternalFormat::R16F),
+        RGBA32UI = static_cast<GLenum>(InternalFormat::RGBA32UI),
+        RGBA16UI = static_cast<GLenum>(InternalFormat::RGBA16UI),
+        RGBA8UI = static_cast<GLenum>(InternalFormat::RGBA8UI),
+        RG32UI = static_cast<GLenum>(InternalFormat::RG32UI),
+        R32UI = static_cast<GLenum>(InternalFormat::R32UI),
+        R32I = static_cast<GLenum>(InternalFormat::R32I),
+        R8UI = static_cast<GLenum>(InternalFormat::R8UI),
+        RGBA8 = static_cast<GLenum>(InternalFormat::RGBA8),
+        RGBA8_SNORM = static_cast<GLenum>(InternalFormat::RGBA8_SNORM),
+        RGB10_A2 = static_cast<GLenum>(InternalFormat::RGB10_A2),
+        RG8 = static_cast<GLenum>(InternalFormat::RG8),
+        R8 = static_cast<GLenum>(InternalFormat::R8),
     };
 
+    [[nodiscard]] constexpr InternalFormat ToInternalFormat(ImageFormat format) {
+        return static_cast<InternalFormat>(format);
+    }
+
+    [[nodiscard]] constexpr const char* GetImageFormatQualifier(ImageFormat format) {
+        switch (format) {
+            case ImageFormat::RGBA32F: return "rgba32f";
+            case ImageFormat::RGBA16F: return "rgba16f";
+            case ImageFormat::RG32F: return "rg32f";
+            case ImageFormat::RG16F: return "rg16f";
+            case ImageFormat::R11F_G11F_B10F: return "r11f_g11f_b10f";
+            case ImageFormat::R32F: return "r32f";
+            case ImageFormat::R16F: return "r16f";
+            case ImageFormat::RGBA32UI: return "rgba32ui";
+            case ImageFormat::RGBA16UI: return "rgba16ui";
+            case ImageFormat::RGBA8UI: return "rgba8ui";
+            case ImageFormat::RG32UI: return "rg32ui";
+            case ImageFormat::R32UI: return "r32ui";
+            case ImageFormat::R32I: return "r32i";
+            case ImageFormat::R8UI: return "r8ui";
+            case ImageFormat::RGBA8: return "rgba8";
+            case ImageFormat::RGBA8_SNORM: return "rgba8_snorm";
+            case ImageFormat::RGB10_A2: return "rgb10_a2";
+            case ImageFormat::RG8: return "rg8";
+            case ImageFormat::R8: return "r8";
+        }
+        return "";
+    }
+
+    [[nodiscard]] constexpr bool IsImageFormat(InternalFormat format) {
+        return GetImageFormatQualifier(static_cast<ImageFormat>(format))[0] != '\0';
+    }
+
+    // Images are bound with format compatibility by size: any uncompressed color format with the same texel size
+    // may be reinterpreted, e.g. an RGBA8 texture as R32UI.
+    [[nodiscard]] constexpr bool IsImageCompatible(InternalFormat texture, ImageFormat image) {
+        switch (texture) {
+            case InternalFormat::DEPTH_COMPONENT16:
+            case InternalFormat::DEPTH_COMPONENT24:
+            case InternalFormat::DEPTH_COMPONENT32F:
+            case InternalFormat::DEPTH24_STENCIL8:
+            case InternalFormat::DEPTH32F_STENCIL8:
+            case InternalFormat::STENCIL_INDEX8: return false;
+            default: return !IsCompressed(texture) && GetBitsPerPixel(texture) == GetBitsPerPixel(ToInternalFormat(image));
+        }
+    }
+
+    static_assert(IsImageFormat(InternalFormat::R32UI) && !IsImageFormat(InternalFormat::SRGB8_ALPHA8));
+    static_assert(IsImageCompatible(InternalFormat::RGBA8, ImageFormat::R32UI) && !IsImageCompatible(InternalFormat::RGBA8, ImageFormat::RG32F));
+    static_assert(!IsImageCompatible(InternalFormat::DEPTH_COMPONENT32F, ImageFormat::R32F));
+
+    // Size in bytes of one mip level; compressed formats are rounded up to whole 4x4 blocks.
+    [[nodiscard]] constexpr uint64_t GetImageSize(InternalFormat format, uint64_t width, uint64_t height = 1, uint64_t depth = 1) {
+        if (IsCompressed(format))
+            return ((width + 3) / 4) * ((height + 3) / 4) * depth * GetBitsPerPixel(format) * 2;
+        return width * height * depth * GetBitsPerPixel(format) / 8;
+    }
+
+    static_assert(GetImageSize(InternalFormat::RGBA8, 256, 256) == 256 * 256 * 4);
+    static_assert(GetImageSize(InternalFormat::RGBA_S3TC_DXT1, 4, 4) == 8);
+    static_assert(GetImageSize(InternalFormat::RGBA_BPTC_UNORM, 1, 1) == 16);
+    static_assert(GetImageSize(InternalFormat::RGBA32F, 2, 2, 2) == 128);
+
     class Buffer {
       public:
         enum class Target : GLenum {
@@ -65,6 +510,7 @@ namespace glw {
             ShaderStorage = GL_SHADER_STORAGE_BUFFER,
             Uniform = GL_UNIFORM_BUFFER,
             TransformFeedback = GL_TRANSFORM_FEEDBACK_BUFFER,
+            Parameter = GL_PARAMETER_BUFFER,
         };
 
         enum class Usage : GLenum {
@@ -80,12 +526,26 @@ namespace glw {
             Unset = 0,
         };
 
+        enum class StorageFlags : GLbitfield {
+            None = 0,
+            DynamicStorage = GL_DYNAMIC_STORAGE_BIT,
+            MapRead = GL_MAP_READ_BIT,
+            MapWrite = GL_MAP_WRITE_BIT,
+            MapPersistent = GL_MAP_PERSISTENT_BIT,
+            MapCoherent = GL_MAP_COHERENT_BIT,
+            ClientStorage = GL_CLIENT_STORAGE_BIT,
+        };
+
         Buffer(size_t size, const void* data = nullptr, Usage usage = Usage::DynamicDraw);
+        Buffer(size_t size, const void* data, StorageFlags flags);
         ~Buffer();
 
         static std::shared_ptr<Buffer> create(size_t size, const void* data = nullptr, Usage usage = Usage::DynamicDraw);
         static std::unique_ptr<Buffer> createUnique(size_t size, const void* data = nullptr, Usage usage = Usage::DynamicDraw);
 
+        static std::shared_ptr<Buffer> createStorage(size_t size, const void* data, StorageFlags flags);
+        static std::unique_ptr<Buffer> createStorageUnique(size_t size, const void* data, StorageFlags flags);
+
         template<typename T>
         static std::shared_ptr<Buffer> create(const std::vector<T>& data, Usage usage = Usage::DynamicDraw) {
             return create(data.size() * sizeof(T), data.data(), usage);
@@ -110,12 +570,18 @@ namespace glw {
         };
 
         void storage(size_t size, const void* data, Usage usage);
+        void storage(size_t size, const void* data, StorageFlags flags);
 
         template<typename T>
         void storage(const std::vector<T>& data, Usage usage) {
             storage(data.size() * sizeof(T), data.data(), usage);
         };
 
+        template<typename T>
+        void storage(const std::vector<T>& data, StorageFlags flags) {
+            storage(data.size() * sizeof(T), data.data(), flags);
+        };
+
         void subdata(size_t size, const void* data, size_t offset = 0);
 
         template<typename T>
@@ -163,17 +629,97 @@ namespace glw {
 
         [[nodiscard]] void* getMappedPointer() const;
 
+        // Reads, copies and maps first insert the pending barriers for shader writes they would observe. Reads through an
+        // already persistently mapped pointer still need InsertPendingBarriers(BarrierBit::ClientMappedBuffer) and a fence.
         [[nodiscard]] engine::cpu_memory getSubData(const engine::range<size_t>& range);
 
         [[nodiscard]] void* map(GLenum access);
         [[nodiscard]] void* map(GLenum access, const engine::range<size_t>& range);
 
+        bool unmap();
+
+        [[nodiscard]] inline StorageFlags getStorageFlags() const noexcept { return m_StorageFlags; };
+
+        // Moves this buffer's accounted bytes to another category; later reallocations are tracked under it too.
+        void setMemoryTag(MemoryTag tag);
+
+        [[nodiscard]] inline MemoryTag getMemoryTag() const noexcept { return m_MemoryTag; };
+
       private:
+        void trackAllocation(size_t size);
+
+        MemoryTag m_MemoryTag = MemoryTag::General;
         Usage m_CurrentUsage = Usage::Unset;
+        engine::range<size_t> m_MappedRange{};
+        void* m_MappedPointer = nullptr;
+        GLbitfield m_MappedAccess = 0;
+        bool m_Mapped = false;
+        bool m_Immutable = false;
+        StorageFlags m_StorageFlags = StorageFlags::None;
         size_t m_CurrentSize = 0;
         unsigned int m_Buffer = 0;
     };
 
+    constexpr Buffer::StorageFlags operator|(Buffer::StorageFlags a, Buffer::StorageFlags b) {
+        return static_cast<Buffer::StorageFlags>(static_cast<GLbitfield>(a) | static_cast<GLbitfield>(b));
+    }
+
+    constexpr Buffer::StorageFlags operator&(Buffer::StorageFlags a, Buffer::StorageFlags b) {
+        return static_cast<Buffer::StorageFlags>(static_cast<GLbitfield>(a) & static_cast<GLbitfield>(b));
+    }
+
+    class Query {
+      public:
+        enum class Type : GLenum {
+            SamplesPassed = GL_SAMPLES_PASSED,
+            AnySamplesPassed = GL_ANY_SAMPLES_PASSED,
+            AnySamplesPassedConservative = GL_ANY_SAMPLES_PASSED_CONSERVATIVE,
+            PrimitivesGenerated = GL_PRIMITIVES_GENERATED,
+            TransformFeedbackPrimitivesWritten = GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN,
+            TimeElapsed = GL_TIME_ELAPSED,
+            Timestamp = GL_TIMESTAMP,
+        };
+
+        explicit Query(Type type);
+        ~Query();
+
+        Query(const Query&) = delete;
+        Query& operator=(const Query&) = delete;
+
+        void begin();
+        void end();
+
+        void counter();
+
+        [[nodiscard]] bool isResultAvailable() const;
+        [[nodiscard]] uint64_t getResult() const;
+
+        // Has the GPU write the 64-bit result into buffer at offset once it is available, without stalling the CPU.
+        void writeResult(const Buffer* buffer, size_t offset) const;
+
+        [[nodiscard]] inline Type getType() const noexcept { return m_Type; };
+        [[nodiscard]] inline unsigned int getHandle() const noexcept { return m_Query; };
+
+      private:
+        Type m_Type;
+        unsigned int m_Query = 0;
+    };
+
+    class Fence {
+      public:
+        Fence();
+        ~Fence();
+
+        Fence(const Fence&) = delete;
+        Fence& operator=(const Fence&) = delete;
+
+        [[nodiscard]] bool isSignaled() const;
+        bool wait(uint64_t timeoutNanoseconds) const;
+
+      private:
+        GLsync m_Sync = nullptr;
+    };
+
     class VertexArray {
       public:
         struct Attribute {
@@ -206,6 +752,10 @@ namespace glw {
             bindVertexBuffer(buffer.get(), attribs, stride, offset);
         };
 
+        // Re-points `buffers.size()` existing bindings starting at `first` in one call; formats are left untouched. A
+        // null buffer disables its binding.
+        void bindVertexBuffers(unsigned int first, std::span<const Buffer* const> buffers, std::span<const size_t> offsets, std::span<const int> strides);
+
         void bindElementBuffer(const Buffer* buffer);
 
         inline void bindElementBuffer(const std::shared_ptr<Buffer>& buffer) {
@@ -255,15 +805,176 @@ namespace glw {
         void bind(GLenum type) const;
         void bind(Type type) const;
 
+        void bindUnit(unsigned int unit) const;
+
         static void setActiveTextureUnit(unsigned int n);
 
-        void bindImage(unsigned int unit, int level, bool layered, int layer, AccessMode accessMode, GLenum format);
-        void bindImage(unsigned int unit, int level, bool layered, int layer, AccessMode accessMode, Format format);
+        // Binds one level to an image unit. `layered` exposes every layer of array, cubemap and 3D textures; otherwise
+        // only `layer` is bound. The format must match the texture's texel size (see IsImageCompatible).
+        void bindImage(unsigned int unit, int level, bool layered, int layer, AccessMode accessMode, GLenum format) const;
+        void bindImage(unsigned int unit, int level, bool layered, int layer, AccessMode accessMode, ImageFormat format) const;
+
+        // Binds every layer of `level` in the texture's own storage format.
+        void bindImage(unsigned int unit, AccessMode accessMode, int level = 0) const;
+
+        // Number of layers one level exposes to image units: depth for 3D, faces for cubemaps, 1 otherwise.
+        [[nodiscard]] int getImageLayers(int level) const;
+
+        // Immutable storage. Array textures pass their layer count as height (1D) or depth (2D, cubemap arrays use
+        // layers * 6); only Texture3D shrinks depth across mips.
+        void storage1D(int levels, InternalFormat format, int width);
+        void storage2D(int levels, InternalFormat format, int width, int height);
+        void storage3D(int levels, InternalFormat format, int width, int height, int depth);
+        void storage2DMultisample(int samples, InternalFormat format, int width, int height, bool fixedSampleLocations = true);
+
+        // Fills every texel of `level` with one value given in `format`/`type`; null clears to zero.
+        void clear(int level, GLenum format, GLenum type, const void* data = nullptr);
+
+        void setMemoryTag(MemoryTag tag);
+
+        [[nodiscard]] inline MemoryTag getMemoryTag() const noexcept { return m_MemoryTag; };
+        [[nodiscard]] inline uint64_t getMemorySize() const noexcept { return m_MemorySize; };
+
+        [[nodiscard]] inline Type getType() const noexcept { return m_Type; };
+        [[nodiscard]] inline InternalFormat getInternalFormat() const noexcept { return m_InternalFormat; };
+        [[nodiscard]] inline int getLevels() const noexcept { return m_Levels; };
+        [[nodiscard]] inline int getWidth() const noexcept { return m_Width; };
+        [[nodiscard]] inline int getHeight() const noexcept { return m_Height; };
+        [[nodiscard]] inline int getDepth() const noexcept { return m_Depth; };
+
+        [[nodiscard]] inline unsigned int getHandle() const noexcept { return m_Texture; };
 
       private:
+        void trackStorage(int levels, int samples);
+
+        Type m_Type;
+        InternalFormat m_InternalFormat{};
+        MemoryTag m_MemoryTag = MemoryTag::Texture;
+        uint64_t m_MemorySize = 0;
+        int m_Levels = 0;
+        int m_Width = 0;
+        int m_Height = 0;
+        int m_Depth = 0;
         unsigned int m_Texture;
 
+    };
+
+    // One GL call per resource class instead of one per slot. Null entries unbind their slot. Ranges must satisfy
+    // the same offset alignment rules as Buffer::bindRange.
+    void BindBuffersBase(Buffer::Target target, unsigned int first, std::span<const Buffer* const> buffers);
+    void BindBuffersRange(Buffer::Target target, unsigned int first, std::span<const Buffer* const> buffers, std::span<const engine::range<size_t>> ranges);
+
+    void BindTextures(unsigned int first, std::span<const GenericTexture* const> textures);
+
+    // Binds level 0 of each texture with read-write access in its storage format, layered for array, cubemap and 3D
+    // textures.
+    void BindImageTextures(unsigned int first, std::span<const GenericTexture* const> textures);
+
+    class Shader {
+      public:
+        enum class Type : GLenum {
+            Vertex = GL_VERTEX_SHADER,
+            TessControl = GL_TESS_CONTROL_SHADER,
+            TessEvaluation = GL_TESS_EVALUATION_SHADER,
+            Geometry = GL_GEOMETRY_SHADER,
+            Fragment = GL_FRAGMENT_SHADER,
+            Compute = GL_COMPUTE_SHADER,
+        };
+
+        struct SpecializationConstant {
+            unsigned int index;
+            uint32_t value;
+
+            template<typename T>
+            static SpecializationConstant of(unsigned int index, T value) {
+                static_assert(sizeof(T) == sizeof(uint32_t), "Specialization constants must be 32-bit scalars");
+                return {index, std::bit_cast<uint32_t>(value)};
+            };
+        };
+
+        explicit Shader(Type type);
+        ~Shader();
+
+        Shader(const Shader&) = delete;
+        Shader& operator=(const Shader&) = delete;
+
+        static std::unique_ptr<Shader> fromSource(Type type, const std::string& source);
+        static std::unique_ptr<Shader> fromSpirV(Type type, const std::vector<uint32_t>& binary, const std::string& entryPoint = "main",
+                                                 const std::vector<SpecializationConstant>& constants = {});
+
+        void source(const std::string& source);
+        void compile();
+
+        void binary(const std::vector<uint32_t>& spirv);
+        void specialize(const std::string& entryPoint, const std::vector<SpecializationConstant>& constants = {});
+
+        [[nodiscard]] bool isCompiled() const;
+        [[nodiscard]] std::string getInfoLog() const;
+
+        [[nodiscard]] inline Type getType() const noexcept { return m_Type; };
+        [[nodiscard]] inline unsigned int getHandle() const noexcept { return m_Shader; };
+
+      private:
+        Type m_Type;
+        unsigned int m_Shader = 0;
+    };
+
+    class Program {
+      public:
+        struct ShaderSource {
+            Shader::Type stage;
+            std::string source;
+        };
+
+        struct SpirVModule {
+            Shader::Type stage;
+            std::vector<uint32_t> binary;
+            std::string entryPoint = "main";
+            std::vector<Shader::SpecializationConstant> constants;
+        };
+
+        Program();
+        ~Program();
+
+        Program(const Program&) = delete;
+        Program& operator=(const Program&) = delete;
+
+        static std::shared_ptr<Program> create(const std::vector<ShaderSource>& sources);
+        static std::shared_ptr<Program> createFromSpirV(const std::vector<SpirVModule>& modules);
+
+        // Issues compilation and linking without waiting on the result. With KHR_parallel_shader_compile the driver
+        // builds the program on its own threads; poll isReady() and call finish() before first use.
+        static std::shared_ptr<Program> createAsync(const std::vector<ShaderSource>& sources);
+
+        void attach(const Shader* shader);
+        void detach(const Shader* shader);
+
+        void link();
+        void use() const;
+
+        // Sets a default-block uniform without binding the program (glProgramUniform1ui).
+        void setUniform(int location, uint32_t value) const;
+
+        [[nodiscard]] bool isReady() const;
+        void finish();
+
+        [[nodiscard]] bool isLinked() const;
+        [[nodiscard]] std::string getInfoLog() const;
+
+        [[nodiscard]] inline unsigned int getHandle() const noexcept { return m_Program; };
+
+        // Populated by link() and by finish() for asynchronously built programs.
+        [[nodiscard]] inline const ProgramReflection& getReflection() const noexcept { return m_Reflection; };
+
+        // Opt-in: gives resources that share a binding (typically samplers left at unit 0) free slots of their own.
+        // Call after link() or finish(); look bindings up through getReflection() afterwards.
+        void resolveBindingConflicts();
+
+      private:
+        unsigned int m_Program = 0;
+        ProgramReflection m_Reflection;
 
+        std::vector<std::unique_ptr<Shader>> m_PendingShaders;
     };
 
     class Texture1D {
@@ -0,0 +1,683 @@
+#include "engine/gl_capture.hpp"
+#include "engine/gl.hpp"
+#include "engine/gl_pipeline.hpp"
+#include "engine/gl_sampler.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// Trace layout: "GLWTRACE", u32 version, renderer and version strings, then records of u16 op, u32 payload size and
+// the payload. Values are stored in host byte order; strings and vectors carry a u32 count. Blobs start with a kind
+// byte: 0 = null, 1 = new contents (u64 size + bytes, assigned the next id), 2 = u32 id of earlier contents.
+
+namespace glw {
+    static constexpr char     TraceMagic[8] = {'G', 'L', 'W', 'T', 'R', 'A', 'C', 'E'};
+    static constexpr uint32_t TraceVersion  = 1;
+
+    enum BlobKind : uint8_t {
+        BlobNull,
+        BlobDefine,
+        BlobReference,
+    };
+
+    namespace detail {
+        CaptureWriter* g_Capture = nullptr;
+
+        size_t GetClearValueSize(GLenum format, GLenum type) {
+            switch (type) {
+                case GL_UNSIGNED_BYTE_3_3_2:
+                case GL_UNSIGNED_BYTE_2_3_3_REV: return 1;
+                case GL_UNSIGNED_SHORT_5_6_5:
+                case GL_UNSIGNED_SHORT_5_6_5_REV:
+                case GL_UNSIGNED_SHORT_4_4_4_4:
+                case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+                case GL_UNSIGNED_SHORT_5_5_5_1:
+                case GL_UNSIGNED_SHORT_1_5_5_5_REV: return 2;
+                case GL_UNSIGNED_INT_8_8_8_8:
+                case GL_UNSIGNED_INT_8_8_8_8_REV:
+                case GL_UNSIGNED_INT_10_10_10_2:
+                case GL_UNSIGNED_INT_2_10_10_10_REV:
+                case GL_UNSIGNED_INT_10F_11F_11F_REV:
+                case GL_UNSIGNED_INT_5_9_9_9_REV: return 4;
+                default: break;
+            }
+
+            size_t components = 4;
+            switch (format) {
+                case GL_RED:
+                case GL_RED_INTEGER:
+                case GL_GREEN:
+                case GL_BLUE:
+                case GL_STENCIL_INDEX:
+                case GL_DEPTH_COMPONENT: components = 1; break;
+                case GL_RG:
+                case GL_RG_INTEGER: components = 2; break;
+                case GL_RGB:
+                case GL_RGB_INTEGER:
+                case GL_BGR:
+                case GL_BGR_INTEGER: components = 3; break;
+                default: break;
+            }
+
+            switch (type) {
+                case GL_BYTE:
+                case GL_UNSIGNED_BYTE: return components;
+                case GL_SHORT:
+                case GL_UNSIGNED_SHORT:
+                case GL_HALF_FLOAT: return components * 2;
+                default: return components * 4;
+            }
+        }
+
+        static uint64_t HashBlob(const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            uint64_t    hash  = 0xCBF29CE484222325ull ^ (size * 0x9E3779B97F4A7C15ull);
+            size_t      i     = 0;
+            for (; i + 8 <= size; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, bytes + i, sizeof(word));
+                hash = (hash ^ word) * 0x100000001B3ull;
+                hash ^= hash >> 29;
+            }
+            for (; i < size; i++) hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+            return hash;
+        }
+
+        CaptureWriter::CaptureWriter(std::FILE* file) : m_File(file) {}
+
+        CaptureWriter::~CaptureWriter() {
+            std::fclose(m_File);
+        }
+
+        void CaptureWriter::write(const std::string& value) {
+            write(static_cast<uint32_t>(value.size()));
+            append(value.data(), value.size());
+        }
+
+        void CaptureWriter::write(const CaptureBlob& blob) {
+            if (!blob.data) {
+                write(BlobNull);
+                return;
+            }
+
+            // Replay keeps the whole trace in memory anyway, so holding one copy of each distinct blob here is no worse.
+            uint64_t   hash  = HashBlob(blob.data, blob.size);
+            const auto range = m_Blobs.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                const auto& contents = m_BlobContents[it->second];
+                if (contents.size() == blob.size && std::memcmp(contents.data(), blob.data, blob.size) == 0) {
+                    write(BlobReference);
+                    write(it->second);
+                    return;
+                }
+            }
+
+            const auto* bytes = static_cast<const uint8_t*>(blob.data);
+            m_Blobs.emplace(hash, static_cast<uint32_t>(m_BlobContents.size()));
+            m_BlobContents.emplace_back(bytes, bytes + blob.size);
+
+            write(BlobDefine);
+            write(static_cast<uint64_t>(blob.size));
+            append(blob.data, blob.size);
+        }
+
+        void CaptureWriter::append(const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            m_Payload.insert(m_Payload.end(), bytes, bytes + size);
+        }
+
+        void CaptureWriter::commit(CaptureOp op) {
+            auto opcode = static_cast<uint16_t>(op);
+            auto size   = static_cast<uint32_t>(m_Payload.size());
+            std::fwrite(&opcode, sizeof(opcode), 1, m_File);
+            std::fwrite(&size, sizeof(size), 1, m_File);
+            std::fwrite(m_Payload.data(), 1, m_Payload.size(), m_File);
+        }
+    } // namespace detail
+
+    bool BeginCapture(const std::string& path) {
+#ifdef ENGINE_ENABLE_CAPTURE
+        EndCapture();
+
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            spdlog::error("Failed to open capture file '{}'", path);
+            return false;
+        }
+
+        const auto& caps = GetCapabilities();
+        auto        writeString = [&](const std::string& s) {
+            auto size = static_cast<uint32_t>(s.size());
+            std::fwrite(&size, sizeof(size), 1, file);
+            std::fwrite(s.data(), 1, s.size(), file);
+        };
+        std::fwrite(TraceMagic, sizeof(TraceMagic), 1, file);
+        std::fwrite(&TraceVersion, sizeof(TraceVersion), 1, file);
+        writeString(caps.renderer);
+        writeString(caps.version);
+
+        detail::g_Capture = new detail::CaptureWriter(file);
+        spdlog::info("Capturing glw calls to '{}'", path);
+        return true;
+#else
+        spdlog::warn("Cannot capture to '{}': the engine was built without ENGINE_ENABLE_CAPTURE", path);
+        return false;
+#endif
+    }
+
+    void EndCapture() {
+        delete detail::g_Capture;
+        detail::g_Capture = nullptr;
+    }
+
+    bool IsCapturing() {
+        return detail::g_Capture != nullptr;
+    }
+
+    void CaptureMappedWrite(const Buffer* buffer, const engine::range<size_t>& range, const void* data) {
+        GLW_CAPTURE(BufferWrite, buffer->getHandle(), range.offset, detail::CaptureBlob{data, range.size});
+    }
+
+    struct CaptureReplayer::Reader {
+        const uint8_t* data;
+        size_t         size;
+        size_t         cursor = 0;
+
+        const uint8_t* take(size_t count) {
+            if (count > size - cursor)
+                throw std::runtime_error("Truncated capture record");
+            const uint8_t* p = data + cursor;
+            cursor += count;
+            return p;
+        }
+
+        template<typename T>
+        T read() {
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        std::string readString() {
+            auto size = read<uint32_t>();
+            return {reinterpret_cast<const char*>(take(size)), size};
+        }
+
+        template<typename T>
+        std::vector<T> readVector() {
+            auto           count = read<uint32_t>();
+            std::vector<T> values(count);
+            std::memcpy(values.data(), take(count * sizeof(T)), count * sizeof(T));
+            return values;
+        }
+    };
+
+    CaptureReplayer::CaptureReplayer(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Failed to open capture '" + path + "'");
+        m_Data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        Reader header{m_Data.data(), m_Data.size()};
+        if (std::memcmp(header.take(sizeof(TraceMagic)), TraceMagic, sizeof(TraceMagic)) != 0)
+            throw std::runtime_error("'" + path + "' is not a glw capture");
+        if (auto version = header.read<uint32_t>(); version != TraceVersion)
+            throw std::runtime_error("Unsupported capture version " + std::to_string(version));
+        m_Renderer = header.readString();
+        m_Version  = header.readString();
+        m_Start    = header.cursor;
+
+        // Walk the records once to validate framing and count frames.
+        for (size_t cursor = m_Start; cursor < m_Data.size();) {
+            Reader record{m_Data.data() + cursor, m_Data.size() - cursor};
+            auto   op   = record.read<uint16_t>();
+            auto   size = record.read<uint32_t>();
+            record.take(size);
+            if (op >= static_cast<uint16_t>(detail::CaptureOp::Count))
+                throw std::runtime_error("Unknown capture op " + std::to_string(op));
+            if (op == static_cast<uint16_t>(detail::CaptureOp::FrameEnd))
+                m_FrameCount++;
+            m_CommandCount++;
+            cursor += record.cursor;
+        }
+
+        m_Cursor = m_Start;
+    }
+
+    CaptureReplayer::~CaptureReplayer() {
+        rewind();
+    }
+
+    bool CaptureReplayer::replayFrame() {
+        while (m_Cursor < m_Data.size()) {
+            Reader header{m_Data.data() + m_Cursor, m_Data.size() - m_Cursor};
+            auto   op   = header.read<uint16_t>();
+            auto   size = header.read<uint32_t>();
+
+            Reader payload{m_Data.data() + m_Cursor + header.cursor, size};
+            m_Cursor += header.cursor + size;
+
+            execute(op, payload);
+            if (op == static_cast<uint16_t>(detail::CaptureOp::FrameEnd))
+                return true;
+        }
+        return false;
+    }
+
+    void CaptureReplayer::rewind() {
+        for (auto& [handle, mapping] : m_Mappings) m_Buffers.at(handle)->unmap();
+        m_Mappings.clear();
+        m_Programs.clear();
+        m_Shaders.clear();
+        m_VertexArrays.clear();
+        m_Textures.clear();
+        m_Samplers.clear();
+        m_Buffers.clear();
+        m_Blobs.clear();
+        m_StateCache.reset();
+        m_Cursor = m_Start;
+    }
+
+    void CaptureReplayer::execute(uint16_t op, Reader& r) {
+        using detail::CaptureOp;
+
+        auto blob = [&]() -> std::pair<const uint8_t*, size_t> {
+            switch (r.read<uint8_t>()) {
+                case BlobNull: return {nullptr, 0};
+                case BlobDefine: {
+                    auto size = r.read<uint64_t>();
+                    m_Blobs.emplace_back(r.take(size), size);
+                    return m_Blobs.back();
+                }
+                default: return m_Blobs.at(r.read<uint32_t>());
+            }
+        };
+
+        auto buffer  = [&] { return m_Buffers.at(r.read<uint32_t>()).get(); };
+        auto texture = [&] { return m_Textures.at(r.read<uint32_t>()).get(); };
+        auto shader  = [&] { return m_Shaders.at(r.read<uint32_t>()).get(); };
+        auto program = [&] { return m_Programs.at(r.read<uint32_t>()).get(); };
+        auto vao     = [&] { return m_VertexArrays.at(r.read<uint32_t>()).get(); };
+
+        // Handle arrays of the multi-bind ops; 0 stays null.
+        auto objects = [&](const auto& map) {
+            using Object = typename std::remove_cvref_t<decltype(map)>::mapped_type::element_type;
+            std::vector<const Object*> result;
+            for (auto handle : r.readVector<uint32_t>()) result.push_back(handle ? map.at(handle).get() : nullptr);
+            return result;
+        };
+
+        switch (static_cast<CaptureOp>(op)) {
+            case CaptureOp::FrameEnd: ResetFrameStats(); break;
+
+            // An empty, unallocated buffer; the allocation that followed in the capture is the next record.
+            case CaptureOp::BufferCreate: m_Buffers[r.read<uint32_t>()] = std::make_unique<Buffer>(0, nullptr, Buffer::Usage::Unset); break;
+            case CaptureOp::BufferDelete: {
+                auto handle = r.read<uint32_t>();
+                m_Mappings.erase(handle);
+                m_Buffers.erase(handle);
+                break;
+            }
+            case CaptureOp::BufferData: {
+                auto* b         = buffer();
+                auto  size      = r.read<size_t>();
+                auto  usage     = r.read<GLenum>();
+                auto  [data, _] = blob();
+                b->set(size, data, static_cast<Buffer::Usage>(usage));
+                break;
+            }
+            case CaptureOp::BufferStorage: {
+                auto* b         = buffer();
+                auto  size      = r.read<size_t>();
+                auto  flags     = r.read<GLbitfield>();
+                auto  [data, _] = blob();
+                b->storage(size, data, static_cast<Buffer::StorageFlags>(flags));
+                break;
+            }
+            case CaptureOp::BufferSubData: {
+                auto* b            = buffer();
+                auto  offset       = r.read<size_t>();
+                auto  [data, size] = blob();
+                b->subdata(size, data, offset);
+                break;
+            }
+            case CaptureOp::BufferWrite: {
+                auto handle       = r.read<uint32_t>();
+                auto offset       = r.read<size_t>();
+                auto [data, size] = blob();
+                auto mapping      = m_Mappings.find(handle);
+                if (mapping != m_Mappings.end())
+                    std::memcpy(static_cast<uint8_t*>(mapping->second.pointer) + (offset - mapping->second.offset), data, size);
+                else
+                    m_Buffers.at(handle)->subdata(size, data, offset);
+                break;
+            }
+            case CaptureOp::BufferBind: {
+                auto* b = buffer();
+                b->bind(r.read<GLenum>());
+                break;
+            }
+            case CaptureOp::BufferBindBase: {
+                auto* b      = buffer();
+                auto  target = r.read<GLenum>();
+                b->bindBase(target, r.read<unsigned int>());
+                break;
+            }
+            case CaptureOp::BufferBindRange: {
+                auto* b      = buffer();
+                auto  target = r.read<GLenum>();
+                auto  index  = r.read<unsigned int>();
+                auto  offset = r.read<size_t>();
+                b->bindRange(target, index, {offset, r.read<size_t>()});
+                break;
+            }
+            case CaptureOp::BufferClear: {
+                auto* b              = buffer();
+                auto  offset         = r.read<size_t>();
+                auto  size           = r.read<size_t>();
+                auto  internalFormat = r.read<GLenum>();
+                auto  format         = r.read<GLenum>();
+                auto  type           = r.read<GLenum>();
+                auto  [data, _]      = blob();
+                b->clear(offset, size, internalFormat, format, type, data);
+                break;
+            }
+            case CaptureOp::BufferCopy: {
+                auto* source            = buffer();
+                auto* destination       = buffer();
+                auto  sourceOffset      = r.read<size_t>();
+                auto  destinationOffset = r.read<size_t>();
+                source->copyTo(destination, {sourceOffset, r.read<size_t>()}, destinationOffset);
+                break;
+            }
+            case CaptureOp::BufferMap: {
+                auto  handle  = r.read<uint32_t>();
+                auto* b       = m_Buffers.at(handle).get();
+                auto  access  = r.read<GLenum>();
+                auto  ranged  = r.read<bool>();
+                auto  offset  = r.read<size_t>();
+                auto  size    = r.read<size_t>();
+                void* pointer = ranged ? b->map(access, {offset, size}) : b->map(access);
+                m_Mappings[handle] = {pointer, offset};
+                break;
+            }
+            case CaptureOp::BufferFlush: {
+                auto* b      = buffer();
+                auto  offset = r.read<size_t>();
+                b->flushMappedRange({offset, r.read<size_t>()});
+                break;
+            }
+            case CaptureOp::BufferUnmap: {
+                auto handle = r.read<uint32_t>();
+                m_Buffers.at(handle)->unmap();
+                m_Mappings.erase(handle);
+                break;
+            }
+
+            case CaptureOp::VertexArrayCreate: m_VertexArrays[r.read<uint32_t>()] = std::make_unique<VertexArray>(); break;
+            case CaptureOp::VertexArrayDelete: m_VertexArrays.erase(r.read<uint32_t>()); break;
+            case CaptureOp::VertexArrayVertexBuffer: {
+                auto* v      = vao();
+                auto* b      = buffer();
+                auto  offset = r.read<size_t>();
+                v->bindVertexBuffer(b, r.readVector<size_t>(), offset);
+                break;
+            }
+            case CaptureOp::VertexArrayVertexBufferLayout: {
+                auto* v      = vao();
+                auto* b      = buffer();
+                auto  offset = r.read<size_t>();
+                auto  stride = r.read<size_t>();
+                v->bindVertexBuffer(b, r.readVector<VertexArray::Attribute>(), stride, offset);
+                break;
+            }
+            case CaptureOp::VertexArrayElementBuffer: {
+                auto* v = vao();
+                v->bindElementBuffer(buffer());
+                break;
+            }
+            case CaptureOp::VertexArrayBind: vao()->bind(); break;
+
+            case CaptureOp::TextureCreate: {
+                auto handle = r.read<uint32_t>();
+                m_Textures[handle] = std::make_unique<GenericTexture>(static_cast<GenericTexture::Type>(r.read<GLenum>()));
+                break;
+            }
+            case CaptureOp::TextureDelete: m_Textures.erase(r.read<uint32_t>()); break;
+            case CaptureOp::TextureStorage1D: {
+                auto* t      = texture();
+                auto  levels = r.read<int>();
+                auto  format = r.read<InternalFormat>();
+                t->storage1D(levels, format, r.read<int>());
+                break;
+            }
+            case CaptureOp::TextureStorage2D: {
+                auto* t      = texture();
+                auto  levels = r.read<int>();
+                auto  format = r.read<InternalFormat>();
+                auto  width  = r.read<int>();
+                t->storage2D(levels, format, width, r.read<int>());
+                break;
+            }
+            case CaptureOp::TextureStorage3D: {
+                auto* t      = texture();
+                auto  levels = r.read<int>();
+                auto  format = r.read<InternalFormat>();
+                auto  width  = r.read<int>();
+                auto  height = r.read<int>();
+                t->storage3D(levels, format, width, height, r.read<int>());
+                break;
+            }
+            case CaptureOp::TextureStorage2DMultisample: {
+                auto* t       = texture();
+                auto  samples = r.read<int>();
+                auto  format  = r.read<InternalFormat>();
+                auto  width   = r.read<int>();
+                auto  height  = r.read<int>();
+                t->storage2DMultisample(samples, format, width, height, r.read<bool>());
+                break;
+            }
+            case CaptureOp::TextureBind: {
+                auto* t = texture();
+                t->bind(r.read<GLenum>());
+                break;
+            }
+            case CaptureOp::TextureBindUnit: {
+                auto* t = texture();
+                t->bindUnit(r.read<unsigned int>());
+                break;
+            }
+
+            case CaptureOp::ShaderCreate: {
+                auto handle = r.read<uint32_t>();
+                m_Shaders[handle] = std::make_unique<Shader>(static_cast<Shader::Type>(r.read<GLenum>()));
+                break;
+            }
+            case CaptureOp::ShaderDelete: m_Shaders.erase(r.read<uint32_t>()); break;
+            case CaptureOp::ShaderSource: {
+                auto* s = shader();
+                s->source(r.readString());
+                break;
+            }
+            case CaptureOp::ShaderCompile: shader()->compile(); break;
+            case CaptureOp::ShaderBinary: {
+                auto* s = shader();
+                s->binary(r.readVector<uint32_t>());
+                break;
+            }
+            case CaptureOp::ShaderSpecialize: {
+                auto* s     = shader();
+                auto  entry = r.readString();
+                s->specialize(entry, r.readVector<Shader::SpecializationConstant>());
+                break;
+            }
+
+            case CaptureOp::ProgramCreate: m_Programs[r.read<uint32_t>()] = std::make_unique<Program>(); break;
+            case CaptureOp::ProgramDelete: m_Programs.erase(r.read<uint32_t>()); break;
+            case CaptureOp::ProgramAttach: {
+                auto* p = program();
+                p->attach(shader());
+                break;
+            }
+            case CaptureOp::ProgramDetach: {
+                auto* p = program();
+                p->detach(shader());
+                break;
+            }
+            case CaptureOp::ProgramLink: program()->link(); break;
+            case CaptureOp::ProgramUse: program()->use(); break;
+
+            case CaptureOp::DrawArrays: {
+                auto mode          = r.read<GLenum>();
+                auto first         = r.read<int>();
+                auto count         = r.read<int>();
+                auto instanceCount = r.read<int>();
+                DrawArrays(mode, first, count, instanceCount, r.read<unsigned int>());
+                break;
+            }
+            case CaptureOp::DrawElements: {
+                auto mode          = r.read<GLenum>();
+                auto count         = r.read<int>();
+                auto type          = r.read<GLenum>();
+                auto offset        = r.read<size_t>();
+                auto instanceCount = r.read<int>();
+                auto baseVertex    = r.read<int>();
+                DrawElements(mode, count, type, offset, instanceCount, baseVertex, r.read<unsigned int>());
+                break;
+            }
+            case CaptureOp::MultiDrawArraysIndirect: {
+                auto mode      = r.read<GLenum>();
+                auto indirect  = r.read<size_t>();
+                auto drawCount = r.read<int>();
+                MultiDrawArraysIndirect(mode, indirect, drawCount, r.read<int>());
+                break;
+            }
+            case CaptureOp::MultiDrawElementsIndirect: {
+                auto mode      = r.read<GLenum>();
+                auto type      = r.read<GLenum>();
+                auto indirect  = r.read<size_t>();
+                auto drawCount = r.read<int>();
+                MultiDrawElementsIndirect(mode, type, indirect, drawCount, r.read<int>());
+                break;
+            }
+            case CaptureOp::MultiDrawArraysIndirectCount: {
+                auto mode         = r.read<GLenum>();
+                auto indirect     = r.read<size_t>();
+                auto countOffset  = r.read<size_t>();
+                auto maxDrawCount = r.read<int>();
+                MultiDrawArraysIndirectCount(mode, indirect, countOffset, maxDrawCount, r.read<int>());
+                break;
+            }
+            case CaptureOp::MultiDrawElementsIndirectCount: {
+                auto mode         = r.read<GLenum>();
+                auto type         = r.read<GLenum>();
+                auto indirect     = r.read<size_t>();
+                auto countOffset  = r.read<size_t>();
+                auto maxDrawCount = r.read<int>();
+                MultiDrawElementsIndirectCount(mode, type, indirect, countOffset, maxDrawCount, r.read<int>());
+                break;
+            }
+
+            case CaptureOp::PipelineState: {
+                if (!m_StateCache)
+                    m_StateCache = std::make_unique<StateCache>();
+                m_StateCache->apply(r.read<PipelineState>());
+                break;
+            }
+
+            case CaptureOp::SamplerCreate: {
+                auto handle        = r.read<uint32_t>();
+                m_Samplers[handle] = std::make_unique<Sampler>(r.read<Sampler::Descriptor>());
+                break;
+            }
+            case CaptureOp::SamplerDelete: m_Samplers.erase(r.read<uint32_t>()); break;
+            case CaptureOp::SamplerBind: {
+                auto first   = r.read<unsigned int>();
+                auto handles = r.readVector<uint32_t>();
+                for (auto& handle : handles) handle = handle ? m_Samplers.at(handle)->getHandle() : 0;
+                glBindSamplers(first, static_cast<GLsizei>(handles.size()), handles.data());
+                break;
+            }
+
+            case CaptureOp::BufferBindBases: {
+                auto target  = static_cast<Buffer::Target>(r.read<GLenum>());
+                auto first   = r.read<unsigned int>();
+                auto buffers = objects(m_Buffers);
+                BindBuffersBase(target, first, buffers);
+                break;
+            }
+            case CaptureOp::BufferBindRanges: {
+                auto target  = static_cast<Buffer::Target>(r.read<GLenum>());
+                auto first   = r.read<unsigned int>();
+                auto buffers = objects(m_Buffers);
+                BindBuffersRange(target, first, buffers, r.readVector<engine::range<size_t>>());
+                break;
+            }
+            case CaptureOp::VertexArrayVertexBuffers: {
+                auto* v       = vao();
+                auto  first   = r.read<unsigned int>();
+                auto  buffers = objects(m_Buffers);
+                auto  offsets = r.readVector<size_t>();
+                v->bindVertexBuffers(first, buffers, offsets, r.readVector<int>());
+                break;
+            }
+            case CaptureOp::TextureBindUnits: {
+                auto first = r.read<unsigned int>();
+                BindTextures(first, objects(m_Textures));
+                break;
+            }
+            case CaptureOp::TextureBindImageUnits: {
+                auto first = r.read<unsigned int>();
+                BindImageTextures(first, objects(m_Textures));
+                break;
+            }
+            case CaptureOp::TextureBindImage: {
+                auto* t       = texture();
+                auto  unit    = r.read<unsigned int>();
+                auto  level   = r.read<int>();
+                auto  layered = r.read<bool>();
+                auto  layer   = r.read<int>();
+                auto  access  = static_cast<AccessMode>(r.read<GLenum>());
+                t->bindImage(unit, level, layered, layer, access, r.read<GLenum>());
+                break;
+            }
+            case CaptureOp::InsertMemoryBarrier: {
+                auto barriers = static_cast<BarrierBit>(r.read<GLbitfield>());
+                if (r.read<bool>())
+                    InsertMemoryBarrierByRegion(barriers);
+                else
+                    InsertMemoryBarrier(barriers);
+                break;
+            }
+            case CaptureOp::DispatchCompute: {
+                auto x = r.read<unsigned int>();
+                auto y = r.read<unsigned int>();
+                DispatchCompute(x, y, r.read<unsigned int>());
+                break;
+            }
+            case CaptureOp::DispatchComputeIndirect: {
+                DispatchComputeIndirect(r.read<size_t>());
+                break;
+            }
+            case CaptureOp::TextureClear: {
+                auto* t         = texture();
+                auto  level     = r.read<int>();
+                auto  format    = r.read<GLenum>();
+                auto  type      = r.read<GLenum>();
+                auto  [data, _] = blob();
+                t->clear(level, format, type, data);
+                break;
+            }
+            case CaptureOp::ProgramUniform1ui: {
+                auto* p        = program();
+                auto  location = r.read<int>();
+                p->setUniform(location, r.read<uint32_t>());
+                break;
+            }
+            case CaptureOp::ProgramResolveBindings: program()->resolveBindingConflicts(); break;
+
+            case CaptureOp::Count: break;
+        }
+    }
+} // namespace glw
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "engine/engine.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace glw {
+    class Buffer;
+    class VertexArray;
+    class GenericTexture;
+    class Shader;
+    class Program;
+    class Sampler;
+    class StateCache;
+
+    // Records every glw call (object creation, uploads, binds, draws) into a binary trace until EndCapture(). Each
+    // ResetFrameStats() marks a frame boundary. Raw gl* calls made outside the wrappers are not captured. Only
+    // available when the engine is built with ENGINE_ENABLE_CAPTURE; otherwise BeginCapture() returns false.
+    bool BeginCapture(const std::string& path);
+    void EndCapture();
+    bool IsCapturing();
+
+    // Writes through persistently mapped pointers bypass the wrappers; report them here so the bytes reach the trace.
+    void CaptureMappedWrite(const Buffer* buffer, const engine::range<size_t>& range, const void* data);
+
+    // Re-issues a trace through the glw wrappers on the current context. GL object names from the capture are mapped
+    // to freshly created objects, so the trace replays on any context that supports the recorded calls.
+    class CaptureReplayer {
+      public:
+        explicit CaptureReplayer(const std::string& path);
+        ~CaptureReplayer();
+
+        CaptureReplayer(const CaptureReplayer&)            = delete;
+        CaptureReplayer& operator=(const CaptureReplayer&) = delete;
+
+        // Replays up to and including the next frame boundary. Returns false once the trace is exhausted.
+        bool replayFrame();
+
+        // Destroys every replayed object and restarts from the first command.
+        void rewind();
+
+        [[nodiscard]] inline size_t getFrameCount() const noexcept { return m_FrameCount; };
+        [[nodiscard]] inline size_t getCommandCount() const noexcept { return m_CommandCount; };
+        [[nodiscard]] inline const std::string& getRenderer() const noexcept { return m_Renderer; };
+        [[nodiscard]] inline const std::string& getVersion() const noexcept { return m_Version; };
+
+      private:
+        struct Mapping {
+            void*  pointer;
+            size_t offset;
+        };
+
+        struct Reader;
+
+        void execute(uint16_t op, Reader& reader);
+
+        std::vector<uint8_t> m_Data;
+        size_t               m_Start        = 0;
+        size_t               m_Cursor       = 0;
+        size_t               m_FrameCount   = 0;
+        size_t               m_CommandCount = 0;
+        std::string          m_Renderer;
+        std::string          m_Version;
+
+        std::vector<std::pair<const uint8_t*, size_t>> m_Blobs;
+
+        std::unordered_map<uint32_t, std::unique_ptr<Buffer>>         m_Buffers;
+        std::unordered_map<uint32_t, std::unique_ptr<VertexArray>>    m_VertexArrays;
+        std::unordered_map<uint32_t, std::unique_ptr<GenericTexture>> m_Textures;
+        std::unordered_map<uint32_t, std::unique_ptr<Shader>>         m_Shaders;
+        std::unordered_map<uint32_t, std::unique_ptr<Program>>        m_Programs;
+        std::unordered_map<uint32_t, std::unique_ptr<Sampler>>        m_Samplers;
+        std::unordered_map<uint32_t, Mapping>                         m_Mappings;
+        std::unique_ptr<StateCache>                                   m_StateCache;
+    };
+
+    namespace detail {
+        enum class CaptureOp : uint16_t {
+            FrameEnd,
+            BufferCreate,
+            BufferDelete,
+            BufferData,
+            BufferStorage,
+            BufferSubData,
+            BufferWrite,
+            BufferBind,
+            BufferBindBase,
+            BufferBindRange,
+            BufferClear,
+            BufferCopy,
+            BufferMap,
+            BufferFlush,
+            BufferUnmap,
+            VertexArrayCreate,
+            VertexArrayDelete,
+            VertexArrayVertexBuffer,
+            VertexArrayVertexBufferLayout,
+            VertexArrayElementBuffer,
+            VertexArrayBind,
+            TextureCreate,
+            TextureDelete,
+            TextureStorage1D,
+            TextureStorage2D,
+            TextureStorage3D,
+            TextureStorage2DMultisample,
+            TextureBind,
+            TextureBindUnit,
+            ShaderCreate,
+            ShaderDelete,
+            ShaderSource,
+            ShaderCompile,
+            ShaderBinary,
+            ShaderSpecialize,
+            ProgramCreate,
+            ProgramDelete,
+            ProgramAttach,
+            ProgramDetach,
+            ProgramLink,
+            ProgramUse,
+            DrawArrays,
+            DrawElements,
+            MultiDrawArraysIndirect,
+            MultiDrawElementsIndirect,
+            MultiDrawArraysIndirectCount,
+            MultiDrawElementsIndirectCount,
+            PipelineState,
+            SamplerCreate,
+            SamplerDelete,
+            SamplerBind,
+            BufferBindBases,
+            BufferBindRanges,
+            VertexArrayVertexBuffers,
+            TextureBindUnits,
+            TextureBindImageUnits,
+            TextureBindImage,
+            InsertMemoryBarrier,
+            DispatchCompute,
+            DispatchComputeIndirect,
+            TextureClear,
+            ProgramUniform1ui,
+            ProgramResolveBindings,
+            Count,
+        };
+
+        // Bulk data (uploads, clear values, shader binaries). Identical contents are stored once per trace.
+        struct CaptureBlob {
+            const void* data;
+            size_t      size;
+        };
+
+        size_t GetClearValueSize(GLenum format, GLenum type);
+
+        class CaptureWriter {
+          public:
+            explicit CaptureWriter(std::FILE* file);
+            ~CaptureWriter();
+
+            template<typename... Args>
+            void record(CaptureOp op, const Args&... args) {
+                m_Payload.clear();
+                (write(args), ...);
+                commit(op);
+            };
+
+          private:
+            template<typename T>
+                requires std::is_trivially_copyable_v<T>
+            void write(const T& value) {
+                append(&value, sizeof(T));
+            };
+
+            template<typename T>
+            void write(const std::vector<T>& values) {
+                write(static_cast<uint32_t>(values.size()));
+                append(values.data(), values.size() * sizeof(T));
+            };
+
+            void write(const std::string& value);
+            void write(const CaptureBlob& blob);
+
+            void append(const void* data, size_t size);
+            void commit(CaptureOp op);
+
+            std::FILE*                                  m_File;
+            std::vector<uint8_t>                        m_Payload;
+            std::unordered_multimap<uint64_t, uint32_t> m_Blobs;        // Content hash -> blob id
+            std::vector<std::vector<uint8_t>>           m_BlobContents; // Indexed by blob id, to rule out hash collisions
+        };
+
+        extern CaptureWriter* g_Capture;
+    } // namespace detail
+} // namespace glw
+
+// Arguments are only evaluated while a capture is running, and not at all unless ENGINE_ENABLE_CAPTURE is defined.
+#ifdef ENGINE_ENABLE_CAPTURE
+#define GLW_CAPTURE(op, ...)                                                                                                                         \
+    do {                                                                                                                                             \
+        if (::glw::detail::g_Capture)                                                                                                                \
+            ::glw::detail::g_Capture->record(::glw::detail::CaptureOp::op __VA_OPT__(, ) __VA_ARGS__);                                               \
+    } while (0)
+#else
+#define GLW_CAPTURE(op, ...) ((void)0)
+#endif
@@ -0,0 +1,88 @@
+#include "engine/gl_compute.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace glw {
+    ComputePipeline::ComputePipeline(Descriptor descriptor) : m_Descriptor(std::move(descriptor)) {
+        if (!m_Descriptor.program)
+            throw std::runtime_error("Compute pipeline requires a program");
+
+        std::array<int, 3> size{};
+        glGetProgramiv(m_Descriptor.program->getHandle(), GL_COMPUTE_WORK_GROUP_SIZE, size.data());
+        for (size_t i = 0; i < 3; i++) m_WorkGroupSize[i] = static_cast<unsigned int>(std::max(size[i], 1));
+
+        const auto& reflection = m_Descriptor.program->getReflection();
+        for (const auto& declared : m_Descriptor.resources) {
+            const auto* resource = reflection.find(declared.name);
+            if (!resource || (resource->kind != ProgramResource::Kind::ShaderStorageBlock && resource->kind != ProgramResource::Kind::Image))
+                throw std::runtime_error(fmt::format("Compute pipeline resource '{}' is not an active storage block or image", declared.name));
+        }
+
+        // Any access orders against pending writes (read-after-write and write-after-write alike); only writes mark new ones.
+        for (const auto& resource : reflection.getResources()) {
+            bool storage = resource.kind == ProgramResource::Kind::ShaderStorageBlock;
+            bool image   = resource.kind == ProgramResource::Kind::Image;
+
+            if (resource.kind == ProgramResource::Kind::UniformBlock)
+                m_Reads = m_Reads | BarrierBit::Uniform;
+            if (resource.kind == ProgramResource::Kind::Sampler)
+                m_Reads = m_Reads | BarrierBit::TextureFetch;
+            if (!storage && !image)
+                continue;
+
+            auto access = Access::ReadWrite;
+            for (const auto& declared : m_Descriptor.resources)
+                if (declared.name == resource.name)
+                    access = declared.access;
+
+            m_Reads = m_Reads | (storage ? BarrierBit::ShaderStorage : BarrierBit::ShaderImageAccess);
+            if (access != Access::Read)
+                m_Writes = m_Writes | (storage ? BufferWriteConsumers : ImageWriteConsumers);
+        }
+    }
+
+    std::shared_ptr<ComputePipeline> ComputePipeline::create(const Descriptor& descriptor) {
+        return std::make_shared<ComputePipeline>(descriptor);
+    }
+
+    std::array<unsigned int, 3> ComputePipeline::getGroupCount(unsigned int threadsX, unsigned int threadsY, unsigned int threadsZ) const {
+        return {(threadsX + m_WorkGroupSize[0] - 1) / m_WorkGroupSize[0], (threadsY + m_WorkGroupSize[1] - 1) / m_WorkGroupSize[1],
+                (threadsZ + m_WorkGroupSize[2] - 1) / m_WorkGroupSize[2]};
+    }
+
+    void ComputePipeline::begin(BarrierBit consumers) const {
+        InsertPendingBarriers(consumers);
+        m_Descriptor.program->use();
+    }
+
+    void ComputePipeline::dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const {
+        const auto& limits = GetCapabilities().maxComputeWorkGroupCount;
+        GLW_VALIDATE(groupsX <= static_cast<unsigned int>(limits[0]) && groupsY <= static_cast<unsigned int>(limits[1]) &&
+                         groupsZ <= static_cast<unsigned int>(limits[2]),
+                     "dispatch of {}x{}x{} groups exceeds the limit of {}x{}x{}", groupsX, groupsY, groupsZ, limits[0], limits[1], limits[2]);
+
+        if (groupsX == 0 || groupsY == 0 || groupsZ == 0)
+            return;
+
+        begin(m_Reads);
+        DispatchCompute(groupsX, groupsY, groupsZ);
+        MarkPendingWrites(m_Writes);
+    }
+
+    void ComputePipeline::dispatchThreads(unsigned int threadsX, unsigned int threadsY, unsigned int threadsZ) const {
+        auto groups = getGroupCount(threadsX, threadsY, threadsZ);
+        dispatch(groups[0], groups[1], groups[2]);
+    }
+
+    void ComputePipeline::dispatchIndirect(Buffer& arguments, size_t offset) const {
+        GLW_VALIDATE(offset % 4 == 0, "indirect dispatch offset {} is not a multiple of 4", offset);
+        GLW_VALIDATE(offset + sizeof(DispatchIndirectCommand) <= arguments.getCurrentSize(), "indirect dispatch at {} exceeds buffer {} of size {}", offset,
+                     arguments.getHandle(), arguments.getCurrentSize());
+
+        begin(m_Reads | BarrierBit::Command);
+        arguments.bind(Buffer::Target::DispatchIndirect);
+        DispatchComputeIndirect(offset);
+        MarkPendingWrites(m_Writes);
+    }
+} // namespace glw
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "engine/gl.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace glw {
+    // Layout of one glDispatchComputeIndirect command.
+    struct DispatchIndirectCommand {
+        uint32_t groupsX = 1;
+        uint32_t groupsY = 1;
+        uint32_t groupsZ = 1;
+    };
+
+    // A compute program and the shader storage blocks and images it accesses. Each dispatch first inserts the barriers
+    // its reads need for still-pending writes of earlier work (see MarkPendingWrites), then marks its own writes
+    // pending, so chained passes - including ones driven by GPU-written indirect arguments - need no manual barriers.
+    class ComputePipeline {
+      public:
+        enum class Access {
+            Read,
+            Write,
+            ReadWrite,
+        };
+
+        struct Resource {
+            std::string name; // Shader storage block or image uniform, as reflected.
+            Access      access = Access::ReadWrite;
+        };
+
+        // Reflected storage blocks and images missing from `resources` are treated as read-write.
+        struct Descriptor {
+            std::shared_ptr<Program> program;
+            std::vector<Resource>    resources;
+        };
+
+        explicit ComputePipeline(Descriptor descriptor);
+
+        ComputePipeline(const ComputePipeline&) = delete;
+        ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+        static std::shared_ptr<ComputePipeline> create(const Descriptor& descriptor);
+
+        void dispatch(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1) const;
+
+        // Launches enough workgroups to cover `threadsX * threadsY * threadsZ` invocations; shaders must bounds-check
+        // against the real size.
+        void dispatchThreads(unsigned int threadsX, unsigned int threadsY = 1, unsigned int threadsZ = 1) const;
+
+        // Reads a DispatchIndirectCommand at `offset`. Pending writes to the argument buffer are synchronized first.
+        void dispatchIndirect(Buffer& arguments, size_t offset = 0) const;
+
+        [[nodiscard]] std::array<unsigned int, 3> getGroupCount(unsigned int threadsX, unsigned int threadsY = 1, unsigned int threadsZ = 1) const;
+
+        [[nodiscard]] inline const Program* getProgram() const noexcept { return m_Descriptor.program.get(); };
+        [[nodiscard]] inline const std::array<unsigned int, 3>& getWorkGroupSize() const noexcept { return m_WorkGroupSize; };
+        [[nodiscard]] inline BarrierBit getReadBarriers() const noexcept { return m_Reads; };
+        [[nodiscard]] inline BarrierBit getWriteBarriers() const noexcept { return m_Writes; };
+
+      private:
+        void begin(BarrierBit consumers) const;
+
+        Descriptor m_Descriptor;
+        std::array<unsigned int, 3> m_WorkGroupSize{};
+        BarrierBit m_Reads{};
+        BarrierBit m_Writes{};
+    };
+} // namespace glw
@@ -0,0 +1,368 @@
+#include "engine/gl_debug.hpp"
+#include "engine/gl.hpp"
+#include "engine/profiler.hpp"
+
+#include <spdlog/async.h>
+#include <spdlog/async_logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace glw {
+    static constexpr size_t DebugQueueCapacity = 1024;
+    static constexpr size_t MaxMessageLength   = 512;
+
+    struct DebugMessage {
+        GLenum   source;
+        GLenum   type;
+        GLenum   severity;
+        GLuint   id;
+        uint32_t length;
+        char     text[MaxMessageLength];
+    };
+
+    // Bounded multi-producer queue (Vyukov). Drivers may call back from several threads at once, and the callback must
+    // never block or allocate, so a full queue drops the message and counts it.
+    class DebugQueue {
+      public:
+        DebugQueue() : m_Cells(std::make_unique<Cell[]>(DebugQueueCapacity)) {
+            for (size_t i = 0; i < DebugQueueCapacity; i++) m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        template<typename Fill>
+        bool push(Fill&& fill) noexcept {
+            size_t position = m_Head.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell&    cell     = m_Cells[position & (DebugQueueCapacity - 1)];
+                size_t   sequence = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff     = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (diff == 0) {
+                    if (m_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        fill(cell.message);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    position = m_Head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Single consumer.
+        bool pop(DebugMessage& message) noexcept {
+            Cell&  cell     = m_Cells[m_Tail & (DebugQueueCapacity - 1)];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence != m_Tail + 1)
+                return false;
+
+            message = cell.message;
+            cell.sequence.store(m_Tail + DebugQueueCapacity, std::memory_order_release);
+            m_Tail++;
+            return true;
+        }
+
+      private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            DebugMessage        message;
+        };
+
+        std::unique_ptr<Cell[]>          m_Cells;
+        alignas(64) std::atomic<size_t> m_Head = 0;
+        alignas(64) size_t              m_Tail = 0;
+    };
+
+    struct AtomicDebugCounters {
+        std::atomic<uint64_t> received          = 0;
+        std::atomic<uint64_t> dropped           = 0;
+        std::atomic<uint64_t> suppressed        = 0;
+        std::atomic<uint64_t> errors            = 0;
+        std::atomic<uint64_t> deprecated        = 0;
+        std::atomic<uint64_t> undefinedBehavior = 0;
+        std::atomic<uint64_t> portability       = 0;
+        std::atomic<uint64_t> performance       = 0;
+        std::atomic<uint64_t> bufferMigrations  = 0;
+        std::atomic<uint64_t> shaderRecompiles  = 0;
+        std::atomic<uint64_t> pipelineStalls    = 0;
+        std::atomic<uint64_t> softwareFallbacks = 0;
+    };
+
+    struct RepeatState {
+        uint64_t windowStart = 0;
+        uint32_t count       = 0;
+        uint32_t suppressed  = 0;
+    };
+
+    struct DebugRouter {
+        DebugOutputSettings                           settings;
+        DebugQueue                                    queue;
+        std::atomic<uint32_t>                         signal    = 0;
+        std::atomic<uint64_t>                         pushed    = 0;
+        std::atomic<uint64_t>                         processed = 0;
+        std::atomic<bool>                             running   = true;
+        std::shared_ptr<spdlog::details::thread_pool> pool;
+        std::shared_ptr<spdlog::logger>               logger;
+        std::unordered_map<uint64_t, RepeatState>     repeats;
+        uint64_t                                      lastPrune = 0;
+        std::thread                                   thread;
+    };
+
+    static AtomicDebugCounters          s_Counters;
+    static std::unique_ptr<DebugRouter> s_Router;
+
+    static const char* SourceName(GLenum source) {
+        switch (source) {
+            case GL_DEBUG_SOURCE_API: return "API";
+            case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "Window System";
+            case GL_DEBUG_SOURCE_SHADER_COMPILER: return "Shader Compiler";
+            case GL_DEBUG_SOURCE_THIRD_PARTY: return "Third Party";
+            case GL_DEBUG_SOURCE_APPLICATION: return "Application";
+            default: return "Other";
+        }
+    }
+
+    static const char* TypeName(GLenum type) {
+        switch (type) {
+            case GL_DEBUG_TYPE_ERROR: return "Error";
+            case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "Deprecated";
+            case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "Undefined Behavior";
+            case GL_DEBUG_TYPE_PORTABILITY: return "Portability";
+            case GL_DEBUG_TYPE_PERFORMANCE: return "Performance";
+            case GL_DEBUG_TYPE_MARKER: return "Marker";
+            default: return "Other";
+        }
+    }
+
+    static spdlog::level::level_enum SeverityLevel(GLenum severity) {
+        switch (severity) {
+            case GL_DEBUG_SEVERITY_HIGH: return spdlog::level::err;
+            case GL_DEBUG_SEVERITY_MEDIUM: return spdlog::level::warn;
+            case GL_DEBUG_SEVERITY_LOW: return spdlog::level::info;
+            default: return spdlog::level::debug;
+        }
+    }
+
+    static bool Contains(std::string_view text, std::string_view keyword) {
+        auto it = std::search(text.begin(), text.end(), keyword.begin(), keyword.end(),
+                              [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+        return it != text.end();
+    }
+
+    // Vendors phrase these differently; the keywords cover the NVIDIA, AMD and Mesa wordings.
+    static void ClassifyPerformanceWarning(std::string_view text) {
+        if (Contains(text, "recompil"))
+            s_Counters.shaderRecompiles.fetch_add(1, std::memory_order_relaxed);
+        else if (Contains(text, "memory") && (Contains(text, "video") || Contains(text, "host") || Contains(text, "system") || Contains(text, "migrat")))
+            s_Counters.bufferMigrations.fetch_add(1, std::memory_order_relaxed);
+        else if (Contains(text, "stall") || Contains(text, "sync") || Contains(text, "wait") || Contains(text, "blocking"))
+            s_Counters.pipelineStalls.fetch_add(1, std::memory_order_relaxed);
+        else if (Contains(text, "fallback") || Contains(text, "software") || Contains(text, "emulat"))
+            s_Counters.softwareFallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void Count(const DebugMessage& message) {
+        switch (message.type) {
+            case GL_DEBUG_TYPE_ERROR: s_Counters.errors.fetch_add(1, std::memory_order_relaxed); break;
+            case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: s_Counters.deprecated.fetch_add(1, std::memory_order_relaxed); break;
+            case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: s_Counters.undefinedBehavior.fetch_add(1, std::memory_order_relaxed); break;
+            case GL_DEBUG_TYPE_PORTABILITY: s_Counters.portability.fetch_add(1, std::memory_order_relaxed); break;
+            case GL_DEBUG_TYPE_PERFORMANCE:
+                s_Counters.performance.fetch_add(1, std::memory_order_relaxed);
+                ClassifyPerformanceWarning({message.text, message.length});
+                break;
+            default: break;
+        }
+    }
+
+    static uint64_t MessageKey(const DebugMessage& message) {
+        // Some drivers report id 0 for everything, so the text is part of the key.
+        uint64_t hash = 14695981039346656037ull;
+        for (uint32_t i = 0; i < message.length; i++) hash = (hash ^ static_cast<uint8_t>(message.text[i])) * 1099511628211ull;
+        return hash ^ (static_cast<uint64_t>(message.id) << 32) ^ (static_cast<uint64_t>(message.source) << 16) ^ message.type;
+    }
+
+    static void Route(DebugRouter& router, const DebugMessage& message) {
+        Count(message);
+
+        uint64_t now = engine::profiler::Now() / 1000000;
+        if (now - router.lastPrune >= router.settings.windowMilliseconds) {
+            // Forget messages whose window has run out, or every distinct message text would stay in the map forever.
+            std::erase_if(router.repeats, [&](const auto& entry) {
+                const RepeatState& expired = entry.second;
+                if (now - expired.windowStart < router.settings.windowMilliseconds)
+                    return false;
+                if (expired.suppressed > 0)
+                    router.logger->info("[GL] {} repeated message(s) suppressed in an expired window", expired.suppressed);
+                return true;
+            });
+            router.lastPrune = now;
+        }
+
+        auto& state = router.repeats[MessageKey(message)];
+        if (now - state.windowStart >= router.settings.windowMilliseconds) {
+            if (state.suppressed > 0)
+                router.logger->log(SeverityLevel(message.severity), "[GL {} {} {}] previous message repeated {} more times", SourceName(message.source),
+                                   TypeName(message.type), message.id, state.suppressed);
+            state = {now, 0, 0};
+        }
+
+        if (++state.count > router.settings.burstLimit) {
+            state.suppressed++;
+            s_Counters.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        router.logger->log(SeverityLevel(message.severity), "[GL {} {} {}] {}", SourceName(message.source), TypeName(message.type), message.id,
+                           std::string_view(message.text, message.length));
+    }
+
+    static void RouterThread(DebugRouter& router) {
+        ENGINE_PROFILE_THREAD("GL Debug");
+
+        DebugMessage message;
+        while (router.running.load(std::memory_order_acquire)) {
+            uint32_t seen = router.signal.load(std::memory_order_acquire);
+            while (router.queue.pop(message)) {
+                Route(router, message);
+                router.processed.fetch_add(1, std::memory_order_release);
+            }
+            router.processed.notify_all();
+            router.signal.wait(seen, std::memory_order_acquire);
+        }
+
+        while (router.queue.pop(message)) {
+            Route(router, message);
+            router.processed.fetch_add(1, std::memory_order_release);
+        }
+        router.processed.notify_all();
+    }
+
+    static void GLAD_API_PTR DebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* text, const void* user) {
+        auto* router = static_cast<DebugRouter*>(const_cast<void*>(user));
+        s_Counters.received.fetch_add(1, std::memory_order_relaxed);
+
+        if (severity == GL_DEBUG_SEVERITY_NOTIFICATION && !router->settings.notifications)
+            return;
+
+        bool queued = router->queue.push([&](DebugMessage& message) {
+            size_t size      = length >= 0 ? static_cast<size_t>(length) : std::strlen(text);
+            message.source   = source;
+            message.type     = type;
+            message.severity = severity;
+            message.id       = id;
+            message.length   = static_cast<uint32_t>(std::min(size, MaxMessageLength));
+            std::memcpy(message.text, text, message.length);
+        });
+
+        if (!queued) {
+            s_Counters.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        router->pushed.fetch_add(1, std::memory_order_release);
+        router->signal.fetch_add(1, std::memory_order_release);
+        router->signal.notify_one();
+    }
+
+    bool EnableDebugOutput(const DebugOutputSettings& settings) {
+        const auto& caps = GetCapabilities();
+        if (!caps.hasVersion(4, 3) && !caps.has(Extension::KHR_debug))
+            return false;
+
+        DisableDebugOutput();
+
+        auto router      = std::make_unique<DebugRouter>();
+        router->settings = settings;
+
+        // The async logger only keeps a weak reference to its pool, so the router owns it.
+        auto sinks     = spdlog::default_logger()->sinks();
+        router->pool   = std::make_shared<spdlog::details::thread_pool>(8192, 1);
+        router->logger = std::make_shared<spdlog::async_logger>("gl", sinks.begin(), sinks.end(), router->pool, spdlog::async_overflow_policy::overrun_oldest);
+        router->logger->set_level(spdlog::default_logger()->level());
+        router->thread = std::thread(RouterThread, std::ref(*router));
+
+        glEnable(GL_DEBUG_OUTPUT);
+        if (settings.synchronous)
+            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        else
+            glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+        glDebugMessageCallback(DebugCallback, router.get());
+
+        s_Router = std::move(router);
+        return true;
+    }
+
+    void DisableDebugOutput() {
+        if (!s_Router)
+            return;
+
+        glDebugMessageCallback(nullptr, nullptr);
+        glDisable(GL_DEBUG_OUTPUT);
+
+        // Asynchronous callbacks may still be in flight on driver threads; glFinish makes sure they have returned.
+        glFinish();
+
+        s_Router->running.store(false, std::memory_order_release);
+        s_Router->signal.fetch_add(1, std::memory_order_release);
+        s_Router->signal.notify_one();
+        s_Router->thread.join();
+
+        for (const auto& [key, state] : s_Router->repeats) {
+            if (state.suppressed > 0)
+                s_Router->logger->info("[GL] {} repeated message(s) suppressed in the final window", state.suppressed);
+        }
+        s_Router->logger->flush();
+        s_Router.reset();
+    }
+
+    void FlushDebugOutput() {
+        if (!s_Router)
+            return;
+
+        uint64_t target = s_Router->pushed.load(std::memory_order_acquire);
+        for (;;) {
+            uint64_t processed = s_Router->processed.load(std::memory_order_acquire);
+            if (processed >= target)
+                break;
+            s_Router->processed.wait(processed, std::memory_order_acquire);
+        }
+        s_Router->logger->flush();
+    }
+
+    DebugCounters GetDebugCounters() {
+        auto load = [](const std::atomic<uint64_t>& counter) { return counter.load(std::memory_order_relaxed); };
+
+        DebugCounters counters;
+        counters.received          = load(s_Counters.received);
+        counters.dropped           = load(s_Counters.dropped);
+        counters.suppressed        = load(s_Counters.suppressed);
+        counters.errors            = load(s_Counters.errors);
+        counters.deprecated        = load(s_Counters.deprecated);
+        counters.undefinedBehavior = load(s_Counters.undefinedBehavior);
+        counters.portability       = load(s_Counters.portability);
+        counters.performance       = load(s_Counters.performance);
+        counters.bufferMigrations  = load(s_Counters.bufferMigrations);
+        counters.shaderRecompiles  = load(s_Counters.shaderRecompiles);
+        counters.pipelineStalls    = load(s_Counters.pipelineStalls);
+        counters.softwareFallbacks = load(s_Counters.softwareFallbacks);
+        return counters;
+    }
+
+    void ResetDebugCounters() {
+        for (auto* counter : {&s_Counters.received, &s_Counters.dropped, &s_Counters.suppressed, &s_Counters.errors, &s_Counters.deprecated,
+                              &s_Counters.undefinedBehavior, &s_Counters.portability, &s_Counters.performance, &s_Counters.bufferMigrations,
+                              &s_Counters.shaderRecompiles, &s_Counters.pipelineStalls, &s_Counters.softwareFallbacks}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+} // namespace glw
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "engine/engine.hpp"
+
+namespace glw {
+    struct DebugOutputSettings {
+        // Deliver messages on the thread of the offending call. Slower, but lets a breakpoint in the callback show the
+        // call site.
+        bool synchronous = false;
+
+        // Forward GL_DEBUG_SEVERITY_NOTIFICATION messages (buffer placement hints and similar chatter).
+        bool notifications = false;
+
+        // Identical messages beyond burstLimit within one window are counted but not logged.
+        uint32_t burstLimit         = 5;
+        uint32_t windowMilliseconds = 1000;
+    };
+
+    struct DebugCounters {
+        uint64_t received   = 0;
+        uint64_t dropped    = 0; // queue was full when the driver called back
+        uint64_t suppressed = 0; // rate-limited repeats
+
+        uint64_t errors            = 0;
+        uint64_t deprecated        = 0;
+        uint64_t undefinedBehavior = 0;
+        uint64_t portability       = 0;
+        uint64_t performance       = 0;
+
+        // Performance warnings, classified by their text.
+        uint64_t bufferMigrations  = 0;
+        uint64_t shaderRecompiles  = 0;
+        uint64_t pipelineStalls    = 0;
+        uint64_t softwareFallbacks = 0;
+    };
+
+    // The driver callback only copies the message into a lock-free queue. A background thread deduplicates,
+    // rate-limits and classifies messages, then hands them to an async spdlog logger named "gl" that shares the default
+    // logger's sinks. Returns false when the context supports neither GL 4.3 nor KHR_debug.
+    bool EnableDebugOutput(const DebugOutputSettings& settings = {});
+    void DisableDebugOutput();
+
+    // Blocks until every message queued so far has been routed and written.
+    void FlushDebugOutput();
+
+    DebugCounters GetDebugCounters();
+    void          ResetDebugCounters();
+} // namespace glw
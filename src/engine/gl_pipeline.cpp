@@ -0,0 +1,255 @@
+#include "engine/gl_pipeline.hpp"
+#include "engine/gl_sampler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+
+namespace glw {
+    template<typename... Args>
+    static void HashFields(size_t& seed, const Args&... fields) {
+        (detail::HashCombine(seed, std::hash<Args>{}(fields)), ...);
+    }
+
+    static void HashStencilFace(size_t& seed, const StencilFaceState& face) {
+        HashFields(seed, face.fail, face.depthFail, face.pass, face.compare, face.reference, face.readMask, face.writeMask);
+    }
+
+    size_t GetHash(const PipelineState& state) {
+        size_t seed = 0;
+
+        const auto& b = state.blend;
+        HashFields(seed, b.enabled, b.srcColor, b.dstColor, b.colorOp, b.srcAlpha, b.dstAlpha, b.alphaOp, b.colorWriteMask);
+
+        const auto& d = state.depth;
+        HashFields(seed, d.testEnabled, d.writeEnabled, d.compare);
+
+        HashFields(seed, state.stencil.enabled);
+        HashStencilFace(seed, state.stencil.front);
+        HashStencilFace(seed, state.stencil.back);
+
+        const auto& r = state.rasterizer;
+        HashFields(seed, r.cull, r.frontFace, r.polygonMode, r.depthClamp, r.scissorTest, r.depthBiasConstant, r.depthBiasSlope);
+        return seed;
+    }
+
+    static std::atomic<uint64_t> s_NextPipelineId = 1;
+
+    Pipeline::Pipeline(Descriptor descriptor) : m_Descriptor(std::move(descriptor)), m_Id(s_NextPipelineId.fetch_add(1, std::memory_order_relaxed)) {
+        if (!m_Descriptor.program)
+            throw std::runtime_error("Pipeline requires a program");
+
+        m_Hash = GetHash(m_Descriptor.state);
+        detail::HashCombine(m_Hash, m_Descriptor.program->getHandle());
+    }
+
+    std::shared_ptr<Pipeline> Pipeline::create(const Descriptor& descriptor) {
+        return std::make_shared<Pipeline>(descriptor);
+    }
+
+    static void SetCapability(GLenum capability, bool enabled) {
+        detail::t_FrameStats.stateChanges++;
+        if (enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+    }
+
+    void StateCache::bind(const Pipeline& pipeline) {
+        if (pipeline.getId() == m_CurrentId && m_Valid)
+            return;
+
+        detail::t_FrameStats.pipelineBinds++;
+        m_Current   = &pipeline;
+        m_CurrentId = pipeline.getId();
+
+        if (pipeline.getProgram()->getHandle() != m_Program || !m_Valid) {
+            pipeline.getProgram()->use();
+            m_Program = pipeline.getProgram()->getHandle();
+        }
+
+        applyState(pipeline.getState());
+    }
+
+    void StateCache::bind(const std::shared_ptr<Pipeline>& pipeline) {
+        bind(*pipeline);
+    }
+
+    void StateCache::apply(const PipelineState& state) {
+        m_Current   = nullptr;
+        m_CurrentId = 0;
+        applyState(state);
+    }
+
+    void StateCache::applyState(const PipelineState& state) {
+        bool force = !m_Valid;
+        if (!force && state == m_State)
+            return;
+
+        GLW_CAPTURE(PipelineState, state);
+
+        applyBlend(state.blend, force);
+        applyDepth(state.depth, force);
+        applyStencil(state.stencil, force);
+        applyRasterizer(state.rasterizer, force);
+
+        m_State = state;
+        m_Valid = true;
+    }
+
+    void StateCache::bindSamplers(unsigned int first, std::span<const Sampler* const> samplers) {
+        if (m_Samplers.size() < first + samplers.size())
+            m_Samplers.resize(first + samplers.size(), UnknownSampler);
+
+        size_t begin = samplers.size(), end = 0;
+        for (size_t i = 0; i < samplers.size(); i++) {
+            // Compared by id: GL may hand a deleted sampler's name to a new one, which must still be bound.
+            uint64_t id = samplers[i] ? samplers[i]->getId() : 0;
+            if (m_Samplers[first + i] != id) {
+                m_Samplers[first + i] = id;
+                begin                 = std::min(begin, i);
+                end                   = i + 1;
+            }
+        }
+
+        if (begin >= end)
+            return;
+
+        m_SamplerScratch.clear();
+        for (size_t i = begin; i < end; i++) m_SamplerScratch.push_back(samplers[i] ? samplers[i]->getHandle() : 0);
+        GLW_CAPTURE(SamplerBind, static_cast<unsigned int>(first + begin), m_SamplerScratch);
+        detail::t_FrameStats.samplerBinds++;
+        glBindSamplers(static_cast<GLuint>(first + begin), static_cast<GLsizei>(end - begin), m_SamplerScratch.data());
+    }
+
+    void StateCache::bindSamplers(unsigned int first, std::initializer_list<const Sampler*> samplers) {
+        bindSamplers(first, std::span<const Sampler* const>(samplers.begin(), samplers.size()));
+    }
+
+    void StateCache::invalidate() {
+        m_Current   = nullptr;
+        m_CurrentId = 0;
+        m_Valid     = false;
+        m_CullFace  = 0; // Unknown; a forced apply with culling off does not reissue the face
+        std::fill(m_Samplers.begin(), m_Samplers.end(), UnknownSampler);
+    }
+
+    void StateCache::applyBlend(const BlendState& blend, bool force) {
+        auto& current = m_State.blend;
+        if (!force && blend == current)
+            return;
+
+        if (force || blend.enabled != current.enabled)
+            SetCapability(GL_BLEND, blend.enabled);
+
+        if (force || blend.srcColor != current.srcColor || blend.dstColor != current.dstColor || blend.srcAlpha != current.srcAlpha ||
+            blend.dstAlpha != current.dstAlpha) {
+            detail::t_FrameStats.stateChanges++;
+            glBlendFuncSeparate(static_cast<GLenum>(blend.srcColor), static_cast<GLenum>(blend.dstColor), static_cast<GLenum>(blend.srcAlpha),
+                                static_cast<GLenum>(blend.dstAlpha));
+        }
+
+        if (force || blend.colorOp != current.colorOp || blend.alphaOp != current.alphaOp) {
+            detail::t_FrameStats.stateChanges++;
+            glBlendEquationSeparate(static_cast<GLenum>(blend.colorOp), static_cast<GLenum>(blend.alphaOp));
+        }
+
+        if (force || blend.colorWriteMask != current.colorWriteMask) {
+            detail::t_FrameStats.stateChanges++;
+            uint8_t mask = blend.colorWriteMask;
+            glColorMask((mask & 1) != 0, (mask & 2) != 0, (mask & 4) != 0, (mask & 8) != 0);
+        }
+    }
+
+    void StateCache::applyDepth(const DepthState& depth, bool force) {
+        auto& current = m_State.depth;
+        if (!force && depth == current)
+            return;
+
+        if (force || depth.testEnabled != current.testEnabled)
+            SetCapability(GL_DEPTH_TEST, depth.testEnabled);
+
+        if (force || depth.writeEnabled != current.writeEnabled) {
+            detail::t_FrameStats.stateChanges++;
+            glDepthMask(depth.writeEnabled ? GL_TRUE : GL_FALSE);
+        }
+
+        if (force || depth.compare != current.compare) {
+            detail::t_FrameStats.stateChanges++;
+            glDepthFunc(static_cast<GLenum>(depth.compare));
+        }
+    }
+
+    void StateCache::applyStencil(const StencilState& stencil, bool force) {
+        auto& current = m_State.stencil;
+        if (!force && stencil == current)
+            return;
+
+        if (force || stencil.enabled != current.enabled)
+            SetCapability(GL_STENCIL_TEST, stencil.enabled);
+
+        auto applyFace = [&](GLenum face, const StencilFaceState& next, const StencilFaceState& previous) {
+            if (force || next.compare != previous.compare || next.reference != previous.reference || next.readMask != previous.readMask) {
+                detail::t_FrameStats.stateChanges++;
+                glStencilFuncSeparate(face, static_cast<GLenum>(next.compare), next.reference, next.readMask);
+            }
+
+            if (force || next.fail != previous.fail || next.depthFail != previous.depthFail || next.pass != previous.pass) {
+                detail::t_FrameStats.stateChanges++;
+                glStencilOpSeparate(face, static_cast<GLenum>(next.fail), static_cast<GLenum>(next.depthFail), static_cast<GLenum>(next.pass));
+            }
+
+            if (force || next.writeMask != previous.writeMask) {
+                detail::t_FrameStats.stateChanges++;
+                glStencilMaskSeparate(face, next.writeMask);
+            }
+        };
+
+        applyFace(GL_FRONT, stencil.front, current.front);
+        applyFace(GL_BACK, stencil.back, current.back);
+    }
+
+    void StateCache::applyRasterizer(const RasterizerState& rasterizer, bool force) {
+        auto& current = m_State.rasterizer;
+        if (!force && rasterizer == current)
+            return;
+
+        bool culling = rasterizer.cull != CullMode::None;
+        if (force || culling != (current.cull != CullMode::None))
+            SetCapability(GL_CULL_FACE, culling);
+
+        // The cull face is kept separately: disabling culling leaves GL's face untouched.
+        if (culling && (force || static_cast<GLenum>(rasterizer.cull) != m_CullFace)) {
+            detail::t_FrameStats.stateChanges++;
+            m_CullFace = static_cast<GLenum>(rasterizer.cull);
+            glCullFace(m_CullFace);
+        }
+
+        if (force || rasterizer.frontFace != current.frontFace) {
+            detail::t_FrameStats.stateChanges++;
+            glFrontFace(static_cast<GLenum>(rasterizer.frontFace));
+        }
+
+        if (force || rasterizer.polygonMode != current.polygonMode) {
+            detail::t_FrameStats.stateChanges++;
+            glPolygonMode(GL_FRONT_AND_BACK, static_cast<GLenum>(rasterizer.polygonMode));
+        }
+
+        if (force || rasterizer.depthClamp != current.depthClamp)
+            SetCapability(GL_DEPTH_CLAMP, rasterizer.depthClamp);
+
+        if (force || rasterizer.scissorTest != current.scissorTest)
+            SetCapability(GL_SCISSOR_TEST, rasterizer.scissorTest);
+
+        bool bias        = rasterizer.depthBiasConstant != 0.0f || rasterizer.depthBiasSlope != 0.0f;
+        bool currentBias = current.depthBiasConstant != 0.0f || current.depthBiasSlope != 0.0f;
+        if (force || bias != currentBias)
+            SetCapability(GL_POLYGON_OFFSET_FILL, bias);
+
+        if (bias && (force || rasterizer.depthBiasConstant != current.depthBiasConstant || rasterizer.depthBiasSlope != current.depthBiasSlope)) {
+            detail::t_FrameStats.stateChanges++;
+            glPolygonOffset(rasterizer.depthBiasSlope, rasterizer.depthBiasConstant);
+        }
+    }
+} // namespace glw
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "engine/gl.hpp"
+
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace glw {
+    class Sampler;
+
+    namespace detail {
+        inline void HashCombine(size_t& seed, size_t value) {
+            seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        }
+    } // namespace detail
+
+    enum class CompareOp : GLenum {
+        Never = GL_NEVER,
+        Less = GL_LESS,
+        Equal = GL_EQUAL,
+        LessOrEqual = GL_LEQUAL,
+        Greater = GL_GREATER,
+        NotEqual = GL_NOTEQUAL,
+        GreaterOrEqual = GL_GEQUAL,
+        Always = GL_ALWAYS,
+    };
+
+    enum class BlendFactor : GLenum {
+        Zero = GL_ZERO,
+        One = GL_ONE,
+        SrcColor = GL_SRC_COLOR,
+        OneMinusSrcColor = GL_ONE_MINUS_SRC_COLOR,
+        DstColor = GL_DST_COLOR,
+        OneMinusDstColor = GL_ONE_MINUS_DST_COLOR,
+        SrcAlpha = GL_SRC_ALPHA,
+        OneMinusSrcAlpha = GL_ONE_MINUS_SRC_ALPHA,
+        DstAlpha = GL_DST_ALPHA,
+        OneMinusDstAlpha = GL_ONE_MINUS_DST_ALPHA,
+        ConstantColor = GL_CONSTANT_COLOR,
+        OneMinusConstantColor = GL_ONE_MINUS_CONSTANT_COLOR,
+        SrcAlphaSaturate = GL_SRC_ALPHA_SATURATE,
+    };
+
+    enum class BlendOp : GLenum {
+        Add = GL_FUNC_ADD,
+        Subtract = GL_FUNC_SUBTRACT,
+        ReverseSubtract = GL_FUNC_REVERSE_SUBTRACT,
+        Min = GL_MIN,
+        Max = GL_MAX,
+    };
+
+    enum class StencilOp : GLenum {
+        Keep = GL_KEEP,
+        Zero = GL_ZERO,
+        Replace = GL_REPLACE,
+        Increment = GL_INCR,
+        IncrementWrap = GL_INCR_WRAP,
+        Decrement = GL_DECR,
+        DecrementWrap = GL_DECR_WRAP,
+        Invert = GL_INVERT,
+    };
+
+    enum class CullMode : GLenum {
+        None = 0,
+        Front = GL_FRONT,
+        Back = GL_BACK,
+        FrontAndBack = GL_FRONT_AND_BACK,
+    };
+
+    enum class FrontFace : GLenum {
+        CounterClockwise = GL_CCW,
+        Clockwise = GL_CW,
+    };
+
+    enum class PolygonMode : GLenum {
+        Fill = GL_FILL,
+        Line = GL_LINE,
+        Point = GL_POINT,
+    };
+
+    // Defaults match the initial GL context state.
+    struct BlendState {
+        bool        enabled        = false;
+        BlendFactor srcColor       = BlendFactor::One;
+        BlendFactor dstColor       = BlendFactor::Zero;
+        BlendOp     colorOp        = BlendOp::Add;
+        BlendFactor srcAlpha       = BlendFactor::One;
+        BlendFactor dstAlpha       = BlendFactor::Zero;
+        BlendOp     alphaOp        = BlendOp::Add;
+        uint8_t     colorWriteMask = 0xF; // RGBA, one bit per channel starting with red.
+
+        bool operator==(const BlendState&) const = default;
+    };
+
+    struct DepthState {
+        bool      testEnabled  = false;
+        bool      writeEnabled = true;
+        CompareOp compare      = CompareOp::Less;
+
+        bool operator==(const DepthState&) const = default;
+    };
+
+    struct StencilFaceState {
+        StencilOp fail      = StencilOp::Keep;
+        StencilOp depthFail = StencilOp::Keep;
+        StencilOp pass      = StencilOp::Keep;
+        CompareOp compare   = CompareOp::Always;
+        int       reference = 0;
+        uint32_t  readMask  = ~0u;
+        uint32_t  writeMask = ~0u;
+
+        bool operator==(const StencilFaceState&) const = default;
+    };
+
+    struct StencilState {
+        bool             enabled = false;
+        StencilFaceState front;
+        StencilFaceState back;
+
+        bool operator==(const StencilState&) const = default;
+    };
+
+    struct RasterizerState {
+        CullMode    cull              = CullMode::None;
+        FrontFace   frontFace         = FrontFace::CounterClockwise;
+        PolygonMode polygonMode       = PolygonMode::Fill;
+        bool        depthClamp        = false;
+        bool        scissorTest       = false;
+        float       depthBiasConstant = 0.0f;
+        float       depthBiasSlope    = 0.0f;
+
+        bool operator==(const RasterizerState&) const = default;
+    };
+
+    // The fixed-function part of a pipeline. Trivially copyable so it can be recorded into captures as-is.
+    struct PipelineState {
+        BlendState      blend;
+        DepthState      depth;
+        StencilState    stencil;
+        RasterizerState rasterizer;
+
+        bool operator==(const PipelineState&) const = default;
+    };
+
+    [[nodiscard]] size_t GetHash(const PipelineState& state);
+
+    // Immutable program plus fixed-function state, hashed once on construction.
+    class Pipeline {
+      public:
+        struct Descriptor {
+            std::shared_ptr<Program> program;
+            PipelineState            state;
+        };
+
+        explicit Pipeline(Descriptor descriptor);
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        static std::shared_ptr<Pipeline> create(const Descriptor& descriptor);
+
+        [[nodiscard]] inline const Program* getProgram() const noexcept { return m_Descriptor.program.get(); };
+        [[nodiscard]] inline const PipelineState& getState() const noexcept { return m_Descriptor.state; };
+        [[nodiscard]] inline size_t getHash() const noexcept { return m_Hash; };
+        // Never reused, unlike addresses, so a pipeline created where a destroyed one lived still binds. 0 is never assigned.
+        [[nodiscard]] inline uint64_t getId() const noexcept { return m_Id; };
+
+      private:
+        Descriptor m_Descriptor;
+        size_t m_Hash;
+        uint64_t m_Id;
+    };
+
+    // Mirrors the GL state last applied through it and only issues the calls needed to reach a new pipeline's state.
+    // GL state changed behind its back (raw gl* calls, other libraries) must be followed by invalidate().
+    class StateCache {
+      public:
+        StateCache() = default;
+
+        StateCache(const StateCache&) = delete;
+        StateCache& operator=(const StateCache&) = delete;
+
+        void bind(const Pipeline& pipeline);
+        void bind(const std::shared_ptr<Pipeline>& pipeline);
+
+        // Applies fixed-function state only; the bound program is left alone.
+        void apply(const PipelineState& state);
+
+        // Binds samplers to consecutive texture units starting at `first`; null unbinds. Units whose sampler is
+        // unchanged are skipped and the rest go out in a single glBindSamplers call.
+        void bindSamplers(unsigned int first, std::span<const Sampler* const> samplers);
+        void bindSamplers(unsigned int first, std::initializer_list<const Sampler*> samplers);
+
+        // The next bind(), apply() or bindSamplers() sets every state instead of diffing against the mirror.
+        void invalidate();
+
+        [[nodiscard]] inline const Pipeline* getCurrent() const noexcept { return m_Current; };
+
+      private:
+        void applyState(const PipelineState& state);
+        void applyBlend(const BlendState& blend, bool force);
+        void applyDepth(const DepthState& depth, bool force);
+        void applyStencil(const StencilState& stencil, bool force);
+        void applyRasterizer(const RasterizerState& rasterizer, bool force);
+
+        static constexpr uint64_t UnknownSampler = ~0ull;
+
+        PipelineState m_State;
+        std::vector<uint64_t> m_Samplers; // Sampler::getId() per unit, 0 when unbound
+        std::vector<unsigned int> m_SamplerScratch;
+        const Pipeline* m_Current = nullptr;
+        uint64_t m_CurrentId = 0;
+        unsigned int m_Program = 0;
+        GLenum m_CullFace = GL_BACK;
+        bool m_Valid = false;
+    };
+} // namespace glw
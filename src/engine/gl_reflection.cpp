@@ -0,0 +1,198 @@
+#include "engine/gl_reflection.hpp"
+#include "engine/profiler.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+
+namespace glw {
+    static bool IsSamplerType(GLenum type) {
+        switch (type) {
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW:
+        case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_1D_ARRAY:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_1D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_MULTISAMPLE:
+        case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_BUFFER:
+        case GL_SAMPLER_2D_RECT:
+        case GL_SAMPLER_2D_RECT_SHADOW:
+        case GL_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+        case GL_INT_SAMPLER_1D:
+        case GL_INT_SAMPLER_2D:
+        case GL_INT_SAMPLER_3D:
+        case GL_INT_SAMPLER_CUBE:
+        case GL_INT_SAMPLER_1D_ARRAY:
+        case GL_INT_SAMPLER_2D_ARRAY:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_INT_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_2D_RECT:
+        case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_1D:
+        case GL_UNSIGNED_INT_SAMPLER_2D:
+        case GL_UNSIGNED_INT_SAMPLER_3D:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE:
+        case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+        case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // The image types occupy one contiguous enum range.
+    static bool IsImageType(GLenum type) {
+        return type >= GL_IMAGE_1D && type <= GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY;
+    }
+
+    static std::string GetResourceName(unsigned int program, GLenum interface, unsigned int index, int length) {
+        std::string name(std::max(length, 1), '\0');
+        glGetProgramResourceName(program, interface, index, length, nullptr, name.data());
+        name.resize(std::max(length, 1) - 1);
+        return name;
+    }
+
+    static void ReflectBlocks(unsigned int program, GLenum interface, ProgramResource::Kind kind, std::vector<ProgramResource>& resources) {
+        int count = 0;
+        glGetProgramInterfaceiv(program, interface, GL_ACTIVE_RESOURCES, &count);
+
+        constexpr std::array<GLenum, 3> properties = {GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+        for (int i = 0; i < count; i++) {
+            std::array<int, 3> values{};
+            glGetProgramResourceiv(program, interface, i, properties.size(), properties.data(), values.size(), nullptr, values.data());
+            resources.push_back({GetResourceName(program, interface, i, values[0]), kind, static_cast<unsigned int>(i), -1, static_cast<unsigned int>(values[1]), 1,
+                                 static_cast<size_t>(values[2]), 0});
+        }
+    }
+
+    static void ReflectOpaqueUniforms(unsigned int program, std::vector<ProgramResource>& resources) {
+        int count = 0;
+        glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+
+        constexpr std::array<GLenum, 5> properties = {GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_BLOCK_INDEX, GL_ARRAY_SIZE};
+        for (int i = 0; i < count; i++) {
+            std::array<int, 5> values{};
+            glGetProgramResourceiv(program, GL_UNIFORM, i, properties.size(), properties.data(), values.size(), nullptr, values.data());
+
+            auto type = static_cast<GLenum>(values[1]);
+            if (values[3] != -1 || values[2] < 0 || !(IsSamplerType(type) || IsImageType(type)))
+                continue;
+
+            // Opaque uniforms store their unit as the uniform's value; array elements start from the first one.
+            int unit = 0;
+            glGetUniformiv(program, values[2], &unit);
+
+            auto kind = IsSamplerType(type) ? ProgramResource::Kind::Sampler : ProgramResource::Kind::Image;
+            auto name = GetResourceName(program, GL_UNIFORM, i, values[0]);
+            if (name.ends_with("[0]"))
+                name.resize(name.size() - 3);
+
+            resources.push_back({std::move(name), kind, static_cast<unsigned int>(i), values[2], static_cast<unsigned int>(unit),
+                                 static_cast<unsigned int>(std::max(values[4], 1)), 0, type});
+        }
+    }
+
+    static void AssignBinding(unsigned int program, ProgramResource& resource, unsigned int binding) {
+        switch (resource.kind) {
+        case ProgramResource::Kind::UniformBlock: glUniformBlockBinding(program, resource.index, binding); break;
+        case ProgramResource::Kind::ShaderStorageBlock: glShaderStorageBlockBinding(program, resource.index, binding); break;
+        case ProgramResource::Kind::Sampler:
+        case ProgramResource::Kind::Image: {
+            std::vector<int> units(resource.count);
+            for (unsigned int i = 0; i < resource.count; i++) units[i] = static_cast<int>(binding + i);
+            glProgramUniform1iv(program, resource.location, static_cast<int>(resource.count), units.data());
+            break;
+        }
+        }
+        resource.binding = binding;
+    }
+
+    static bool IsFree(const std::vector<bool>& slots, unsigned int first, unsigned int count) {
+        for (unsigned int i = first; i < first + count; i++)
+            if (i < slots.size() && slots[i])
+                return false;
+        return true;
+    }
+
+    static void Claim(std::vector<bool>& slots, unsigned int first, unsigned int count) {
+        slots.resize(std::max<size_t>(slots.size(), first + count));
+        for (unsigned int i = first; i < first + count; i++) slots[i] = true;
+    }
+
+    // Resources that overlap an earlier one of their kind. GL cannot tell an explicit binding from the default 0, so
+    // nonzero bindings are claimed first and only then the zero ones, in enumeration order.
+    static std::vector<ProgramResource*> FindConflicts(std::vector<ProgramResource>& resources, std::array<std::vector<bool>, 4>& used) {
+        std::vector<ProgramResource*> conflicts;
+        for (bool zero : {false, true}) {
+            for (auto& resource : resources) {
+                if ((resource.binding == 0) != zero)
+                    continue;
+
+                auto& slots = used[static_cast<size_t>(resource.kind)];
+                if (IsFree(slots, resource.binding, resource.count))
+                    Claim(slots, resource.binding, resource.count);
+                else
+                    conflicts.push_back(&resource);
+            }
+        }
+        return conflicts;
+    }
+
+    ProgramReflection::ProgramReflection(unsigned int program) {
+        ENGINE_PROFILE_FUNCTION();
+
+        ReflectBlocks(program, GL_UNIFORM_BLOCK, ProgramResource::Kind::UniformBlock, m_Resources);
+        ReflectBlocks(program, GL_SHADER_STORAGE_BLOCK, ProgramResource::Kind::ShaderStorageBlock, m_Resources);
+        ReflectOpaqueUniforms(program, m_Resources);
+
+        std::array<std::vector<bool>, 4> used;
+        for (const auto* resource : FindConflicts(m_Resources, used)) {
+            m_Conflicts++;
+            spdlog::warn("Program {}: '{}' overlaps binding {} of another resource of its kind", program, resource->name, resource->binding);
+        }
+    }
+
+    void ProgramReflection::resolveConflicts(unsigned int program) {
+        std::array<std::vector<bool>, 4> used;
+        for (auto* resource : FindConflicts(m_Resources, used)) {
+            auto&        slots   = used[static_cast<size_t>(resource->kind)];
+            unsigned int binding = 0;
+            while (!IsFree(slots, binding, resource->count)) binding++;
+
+            spdlog::debug("Program {}: moving '{}' from binding {} to {}", program, resource->name, resource->binding, binding);
+            Claim(slots, binding, resource->count);
+            AssignBinding(program, *resource, binding);
+        }
+        m_Conflicts = 0;
+    }
+
+    const ProgramResource* ProgramReflection::find(std::string_view name) const {
+        auto it = std::find_if(m_Resources.begin(), m_Resources.end(), [&](const ProgramResource& r) { return r.name == name; });
+        return it != m_Resources.end() ? &*it : nullptr;
+    }
+
+    const ProgramResource* ProgramReflection::find(std::string_view name, ProgramResource::Kind kind) const {
+        auto it = std::find_if(m_Resources.begin(), m_Resources.end(), [&](const ProgramResource& r) { return r.kind == kind && r.name == name; });
+        return it != m_Resources.end() ? &*it : nullptr;
+    }
+
+    unsigned int ProgramReflection::getBinding(std::string_view name) const {
+        const auto* resource = find(name);
+        return resource ? resource->binding : InvalidBinding;
+    }
+} // namespace glw
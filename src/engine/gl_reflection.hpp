@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glad/gl.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace glw {
+    struct ProgramResource {
+        enum class Kind : uint8_t {
+            UniformBlock,
+            ShaderStorageBlock,
+            Sampler,
+            Image,
+        };
+
+        std::string  name;
+        Kind         kind;
+        unsigned int index;    // Resource index within its program interface.
+        int          location; // Uniform location of samplers and images, -1 for blocks.
+        unsigned int binding;  // Buffer binding point, texture unit or image unit.
+        unsigned int count;    // Array size of samplers and images, 1 for blocks.
+        size_t       size;     // Block data size in bytes, 0 for samplers and images.
+        GLenum       type;     // GLSL sampler or image type, 0 for blocks.
+    };
+
+    // Active uniform blocks, shader storage blocks, samplers and images of a linked program, queried once through the
+    // program interface API, so callers can look bindings up at load time and reuse them on every draw. Bindings are
+    // left as the shaders declare them; resources of the same kind that share one are logged as conflicts and only
+    // moved by resolveConflicts().
+    class ProgramReflection {
+      public:
+        static constexpr unsigned int InvalidBinding = ~0u;
+
+        ProgramReflection() = default;
+        explicit ProgramReflection(unsigned int program);
+
+        [[nodiscard]] const ProgramResource* find(std::string_view name) const;
+        [[nodiscard]] const ProgramResource* find(std::string_view name, ProgramResource::Kind kind) const;
+
+        // InvalidBinding when the resource is inactive or does not exist.
+        [[nodiscard]] unsigned int getBinding(std::string_view name) const;
+
+        [[nodiscard]] inline const std::vector<ProgramResource>& getResources() const noexcept { return m_Resources; };
+        [[nodiscard]] inline size_t getConflictCount() const noexcept { return m_Conflicts; };
+
+        // Moves every overlapping resource to the lowest free range of its kind. Nonzero bindings never move, since GL
+        // cannot report whether a binding of 0 was explicit; among the zero ones the first enumerated keeps its slot.
+        // Use Program::resolveBindingConflicts() so the change is captured.
+        void resolveConflicts(unsigned int program);
+
+      private:
+        std::vector<ProgramResource> m_Resources;
+        size_t                       m_Conflicts = 0;
+    };
+} // namespace glw
@@ -0,0 +1,74 @@
+#include "engine/gl_sampler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+namespace glw {
+    static std::atomic<uint64_t> s_NextSamplerId = 1;
+
+    Sampler::Sampler(const Descriptor& descriptor) : m_Descriptor(descriptor), m_Id(s_NextSamplerId.fetch_add(1, std::memory_order_relaxed)) {
+        glCreateSamplers(1, &m_Sampler);
+        GLW_CAPTURE(SamplerCreate, m_Sampler, m_Descriptor);
+
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(descriptor.minFilter));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(descriptor.magFilter));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_S, static_cast<GLint>(descriptor.wrapS));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_T, static_cast<GLint>(descriptor.wrapT));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_R, static_cast<GLint>(descriptor.wrapR));
+        glSamplerParameterf(m_Sampler, GL_TEXTURE_LOD_BIAS, descriptor.lodBias);
+        glSamplerParameterf(m_Sampler, GL_TEXTURE_MIN_LOD, descriptor.minLod);
+        glSamplerParameterf(m_Sampler, GL_TEXTURE_MAX_LOD, descriptor.maxLod);
+        glSamplerParameterfv(m_Sampler, GL_TEXTURE_BORDER_COLOR, descriptor.borderColor.data());
+
+        if (descriptor.compare) {
+            glSamplerParameteri(m_Sampler, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            glSamplerParameteri(m_Sampler, GL_TEXTURE_COMPARE_FUNC, static_cast<GLint>(descriptor.compareOp));
+        }
+
+        if (descriptor.maxAnisotropy > 1.0f) {
+            float limit = GetCapabilities().maxTextureMaxAnisotropy;
+            glSamplerParameterf(m_Sampler, GL_TEXTURE_MAX_ANISOTROPY, std::min(descriptor.maxAnisotropy, limit));
+        }
+    }
+
+    Sampler::~Sampler() {
+        GLW_CAPTURE(SamplerDelete, m_Sampler);
+        glDeleteSamplers(1, &m_Sampler);
+    }
+
+    size_t GetHash(const Sampler::Descriptor& d) {
+        size_t seed = 0;
+        auto   hash = [&](const auto& value) { detail::HashCombine(seed, std::hash<std::remove_cvref_t<decltype(value)>>{}(value)); };
+
+        hash(d.minFilter);
+        hash(d.magFilter);
+        hash(d.wrapS);
+        hash(d.wrapT);
+        hash(d.wrapR);
+        hash(d.maxAnisotropy);
+        hash(d.lodBias);
+        hash(d.minLod);
+        hash(d.maxLod);
+        hash(d.compare);
+        hash(d.compareOp);
+        for (float c : d.borderColor) hash(c);
+        return seed;
+    }
+
+    const Sampler* SamplerCache::get(const Sampler::Descriptor& descriptor) {
+        auto& bucket = m_Samplers[GetHash(descriptor)];
+        for (const auto& sampler : bucket) {
+            if (sampler->getDescriptor() == descriptor)
+                return sampler.get();
+        }
+
+        m_Count++;
+        return bucket.emplace_back(std::make_unique<Sampler>(descriptor)).get();
+    }
+
+    void SamplerCache::clear() {
+        m_Samplers.clear();
+        m_Count = 0;
+    }
+} // namespace glw
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "engine/gl.hpp"
+#include "engine/gl_pipeline.hpp"
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace glw {
+    // Filtering and addressing state kept apart from textures, so one sampler serves every texture that shares it.
+    class Sampler {
+      public:
+        enum class Filter : GLenum {
+            Nearest = GL_NEAREST,
+            Linear = GL_LINEAR,
+            NearestMipmapNearest = GL_NEAREST_MIPMAP_NEAREST,
+            LinearMipmapNearest = GL_LINEAR_MIPMAP_NEAREST,
+            NearestMipmapLinear = GL_NEAREST_MIPMAP_LINEAR,
+            LinearMipmapLinear = GL_LINEAR_MIPMAP_LINEAR,
+        };
+
+        enum class Wrap : GLenum {
+            Repeat = GL_REPEAT,
+            MirroredRepeat = GL_MIRRORED_REPEAT,
+            ClampToEdge = GL_CLAMP_TO_EDGE,
+            ClampToBorder = GL_CLAMP_TO_BORDER,
+            MirrorClampToEdge = GL_MIRROR_CLAMP_TO_EDGE,
+        };
+
+        // Defaults match a freshly created GL sampler object.
+        struct Descriptor {
+            Filter               minFilter     = Filter::NearestMipmapLinear;
+            Filter               magFilter     = Filter::Linear;
+            Wrap                 wrapS         = Wrap::Repeat;
+            Wrap                 wrapT         = Wrap::Repeat;
+            Wrap                 wrapR         = Wrap::Repeat;
+            float                maxAnisotropy = 1.0f;
+            float                lodBias       = 0.0f;
+            float                minLod        = -1000.0f;
+            float                maxLod        = 1000.0f;
+            bool                 compare       = false;
+            CompareOp            compareOp     = CompareOp::LessOrEqual;
+            std::array<float, 4> borderColor   = {0.0f, 0.0f, 0.0f, 0.0f};
+
+            bool operator==(const Descriptor&) const = default;
+        };
+
+        explicit Sampler(const Descriptor& descriptor);
+        ~Sampler();
+
+        Sampler(const Sampler&) = delete;
+        Sampler& operator=(const Sampler&) = delete;
+
+        [[nodiscard]] inline const Descriptor& getDescriptor() const noexcept { return m_Descriptor; };
+        [[nodiscard]] inline unsigned int getHandle() const noexcept { return m_Sampler; };
+        // Never reused, unlike GL names, so it can identify a sampler after others were deleted. 0 is never assigned.
+        [[nodiscard]] inline uint64_t getId() const noexcept { return m_Id; };
+
+      private:
+        Descriptor m_Descriptor;
+        unsigned int m_Sampler = 0;
+        uint64_t m_Id = 0;
+    };
+
+    [[nodiscard]] size_t GetHash(const Sampler::Descriptor& descriptor);
+
+    // Deduplicates samplers by descriptor. Returned pointers stay valid until clear() or the cache is destroyed.
+    class SamplerCache {
+      public:
+        SamplerCache() = default;
+
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator=(const SamplerCache&) = delete;
+
+        [[nodiscard]] const Sampler* get(const Sampler::Descriptor& descriptor);
+
+        void clear();
+
+        [[nodiscard]] inline size_t size() const noexcept { return m_Count; };
+
+      private:
+        std::unordered_map<size_t, std::vector<std::unique_ptr<Sampler>>> m_Samplers;
+        size_t m_Count = 0;
+    };
+} // namespace glw
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <stdexcept>
+#include <string>
+
+// Selected per build through the ENGINE_GLW_VALIDATION CMake option: 0 = unchecked, 1 = logged, 2 = checked.
+#ifndef GLW_VALIDATION_LEVEL
+#define GLW_VALIDATION_LEVEL 0
+#endif
+
+namespace glw {
+    enum class ValidationLevel {
+        Unchecked = 0,
+        Logged    = 1,
+        Checked   = 2,
+    };
+
+    template<ValidationLevel Level>
+    struct ValidationPolicy {
+        static constexpr bool Enabled = false;
+
+        template<typename... Args>
+        static void fail(const char*, spdlog::format_string_t<Args...>, Args&&...) {}
+    };
+
+    template<>
+    struct ValidationPolicy<ValidationLevel::Logged> {
+        static constexpr bool Enabled = true;
+
+        template<typename... Args>
+        static void fail(const char* function, spdlog::format_string_t<Args...> format, Args&&... args) {
+            spdlog::error("glw validation failed in {}: {}", function, fmt::format(format, std::forward<Args>(args)...));
+        }
+    };
+
+    template<>
+    struct ValidationPolicy<ValidationLevel::Checked> {
+        static constexpr bool Enabled = true;
+
+        template<typename... Args>
+        [[noreturn]] static void fail(const char* function, spdlog::format_string_t<Args...> format, Args&&... args) {
+            throw std::runtime_error(fmt::format("glw validation failed in {}: {}", function, fmt::format(format, std::forward<Args>(args)...)));
+        }
+    };
+
+    using Validation = ValidationPolicy<static_cast<ValidationLevel>(GLW_VALIDATION_LEVEL)>;
+} // namespace glw
+
+// The condition sits behind `if constexpr`, so unchecked builds never evaluate it, even when it queries GL state.
+#define GLW_VALIDATE(condition, ...)                                                                                                                 \
+    do {                                                                                                                                             \
+        if constexpr (::glw::Validation::Enabled) {                                                                                                  \
+            if (!(condition))                                                                                                                        \
+                ::glw::Validation::fail(__func__, __VA_ARGS__);                                                                                      \
+        }                                                                                                                                            \
+    } while (0)
@@ -0,0 +1,120 @@
+#include "engine/gpu_memory.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace glw {
+    struct TrackedUsage {
+        std::atomic<int64_t>  current     = 0;
+        std::atomic<int64_t>  highWater   = 0;
+        std::atomic<uint64_t> allocations = 0;
+        std::atomic<int64_t>  budget      = 0;
+        MemoryBudgetCallback  onExceeded;
+    };
+
+    static constexpr size_t TagCount = static_cast<size_t>(MemoryTag::Count);
+
+    static std::array<TrackedUsage, TagCount> s_Usage;
+    static TrackedUsage                       s_Total;
+    static std::mutex                         s_CallbackMutex;
+    static thread_local bool                  t_InCallback = false;
+
+    static constexpr std::array<const char*, TagCount> TagNames = {"general", "mesh", "texture", "render target", "staging", "uniform"};
+
+    const char* GetMemoryTagName(MemoryTag tag) {
+        return TagNames[static_cast<size_t>(tag)];
+    }
+
+    static MemoryUsage Snapshot(const TrackedUsage& usage) {
+        return {usage.current.load(std::memory_order_relaxed), usage.highWater.load(std::memory_order_relaxed), usage.allocations.load(std::memory_order_relaxed)};
+    }
+
+    MemoryUsage GetMemoryUsage(MemoryTag tag) {
+        return Snapshot(s_Usage[static_cast<size_t>(tag)]);
+    }
+
+    MemoryUsage GetTotalMemoryUsage() {
+        return Snapshot(s_Total);
+    }
+
+    void SetMemoryBudget(MemoryTag tag, int64_t budget, MemoryBudgetCallback onExceeded) {
+        std::scoped_lock lock(s_CallbackMutex);
+        auto&            usage = s_Usage[static_cast<size_t>(tag)];
+        usage.onExceeded       = std::move(onExceeded);
+        usage.budget.store(budget, std::memory_order_relaxed);
+    }
+
+    void SetTotalMemoryBudget(int64_t budget, MemoryBudgetCallback onExceeded) {
+        std::scoped_lock lock(s_CallbackMutex);
+        s_Total.onExceeded = std::move(onExceeded);
+        s_Total.budget.store(budget, std::memory_order_relaxed);
+    }
+
+    void LogMemoryUsage() {
+        auto log = [](const char* name, const MemoryUsage& usage) {
+            spdlog::info("{:>14}: {:>10.2f} MiB (peak {:>10.2f} MiB, {} allocations)", name, static_cast<double>(usage.current) / (1024.0 * 1024.0),
+                         static_cast<double>(usage.highWater) / (1024.0 * 1024.0), usage.allocations);
+        };
+
+        for (size_t i = 0; i < TagCount; i++) log(TagNames[i], Snapshot(s_Usage[i]));
+        log("total", Snapshot(s_Total));
+    }
+
+    static int64_t Add(TrackedUsage& usage, int64_t bytes) {
+        int64_t current = usage.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        int64_t peak    = usage.highWater.load(std::memory_order_relaxed);
+        while (current > peak && !usage.highWater.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+        return current;
+    }
+
+    static void CheckBudget(TrackedUsage& usage, MemoryTag tag, bool total, int64_t current) {
+        int64_t budget = usage.budget.load(std::memory_order_relaxed);
+        if (budget <= 0 || current <= budget || t_InCallback)
+            return;
+
+        MemoryBudgetCallback callback;
+        {
+            std::scoped_lock lock(s_CallbackMutex);
+            callback = usage.onExceeded;
+        }
+        if (!callback)
+            return;
+
+        // Reset on unwind too, or a throwing callback would silence every later one on this thread.
+        struct CallbackScope {
+            CallbackScope() { t_InCallback = true; };
+            ~CallbackScope() { t_InCallback = false; };
+        } scope;
+        callback({tag, total, current, budget});
+    }
+
+    namespace detail {
+        void TrackAllocation(MemoryTag tag, int64_t bytes) {
+            auto& usage = s_Usage[static_cast<size_t>(tag)];
+            usage.allocations.fetch_add(1, std::memory_order_relaxed);
+            s_Total.allocations.fetch_add(1, std::memory_order_relaxed);
+
+            int64_t current = Add(usage, bytes);
+            int64_t total   = Add(s_Total, bytes);
+
+            CheckBudget(usage, tag, false, current);
+            CheckBudget(s_Total, tag, true, total);
+        }
+
+        void TrackFree(MemoryTag tag, int64_t bytes) {
+            s_Usage[static_cast<size_t>(tag)].current.fetch_sub(bytes, std::memory_order_relaxed);
+            s_Total.current.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        void TrackTransfer(MemoryTag from, MemoryTag to, int64_t bytes) {
+            if (from == to)
+                return;
+
+            s_Usage[static_cast<size_t>(from)].current.fetch_sub(bytes, std::memory_order_relaxed);
+            CheckBudget(s_Usage[static_cast<size_t>(to)], to, false, Add(s_Usage[static_cast<size_t>(to)], bytes));
+        }
+    }
+} // namespace glw
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace glw {
+    enum class MemoryTag : uint8_t {
+        General,
+        Mesh,
+        Texture,
+        RenderTarget,
+        Staging,
+        Uniform,
+        Count,
+    };
+
+    const char* GetMemoryTagName(MemoryTag tag);
+
+    struct MemoryUsage {
+        int64_t  current     = 0;
+        int64_t  highWater   = 0;
+        uint64_t allocations = 0;
+    };
+
+    struct MemoryBudgetEvent {
+        MemoryTag tag;
+        bool      total;
+        int64_t   current;
+        int64_t   budget;
+    };
+
+    // Called when an allocation takes a tag (or the total) past its soft budget. The callback is expected to evict
+    // resources; allocations are never refused. Callbacks are not re-entered while one is running on the same thread.
+    using MemoryBudgetCallback = std::function<void(const MemoryBudgetEvent&)>;
+
+    MemoryUsage GetMemoryUsage(MemoryTag tag);
+    MemoryUsage GetTotalMemoryUsage();
+
+    void SetMemoryBudget(MemoryTag tag, int64_t budget, MemoryBudgetCallback onExceeded);
+    void SetTotalMemoryBudget(int64_t budget, MemoryBudgetCallback onExceeded);
+
+    void LogMemoryUsage();
+
+    namespace detail {
+        void TrackAllocation(MemoryTag tag, int64_t bytes);
+        void TrackFree(MemoryTag tag, int64_t bytes);
+        void TrackTransfer(MemoryTag from, MemoryTag to, int64_t bytes);
+    }
+} // namespace glw
@@ -0,0 +1,208 @@
+#include "engine/gpu_profiler.hpp"
+#include "engine/gl_validation.hpp"
+
+#include <algorithm>
+
+namespace engine {
+    static constexpr const char* FrameScopeName = "Frame";
+
+    GpuProfiler::GpuProfiler(unsigned int latency, unsigned int maxScopesPerFrame, size_t historyLength)
+        : m_MaxScopes(maxScopesPerFrame), m_HistoryLength(historyLength), m_Slots(latency + 1) {
+        const auto& caps = glw::GetCapabilities();
+        m_UseQueryBuffer = caps.hasVersion(4, 4) || caps.has(glw::Extension::ARB_query_buffer_object);
+
+        if (m_UseQueryBuffer) {
+            size_t size    = m_Slots.size() * m_MaxScopes * 2 * sizeof(uint64_t);
+            auto   flags   = glw::Buffer::StorageFlags::MapRead | glw::Buffer::StorageFlags::MapPersistent | glw::Buffer::StorageFlags::MapCoherent;
+            m_ResultBuffer = glw::Buffer::createStorageUnique(size, nullptr, flags);
+            m_Results      = static_cast<const uint64_t*>(m_ResultBuffer->map(GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, {0, size}));
+        }
+
+#ifdef ENGINE_ENABLE_PROFILING
+        m_Track = profiler::CreateTrack("GPU");
+#endif
+        calibrate();
+    }
+
+    GpuProfiler::~GpuProfiler() {
+        if (m_ResultBuffer)
+            m_ResultBuffer->unmap();
+    }
+
+    void GpuProfiler::beginFrame() {
+        ENGINE_PROFILE_FUNCTION();
+
+        for (size_t i = 1; i <= m_Slots.size(); i++) {
+            size_t index = (m_CurrentSlot + i) % m_Slots.size();
+            auto&  slot  = m_Slots[index];
+            if (slot.pending && slot.fence->isSignaled())
+                resolve(slot, index);
+        }
+
+        m_CurrentSlot = m_FrameNumber % m_Slots.size();
+        auto& slot    = m_Slots[m_CurrentSlot];
+
+        // The GPU is more than `latency` frames behind; drop this frame rather than wait for its results.
+        m_Recording = !slot.pending;
+        m_Stack.clear();
+        m_OpenScopes = 0;
+
+        if (m_Recording) {
+            slot.usedQueries = 0;
+            slot.scopes.clear();
+            slot.frameNumber = m_FrameNumber;
+        }
+
+        pushScope(FrameScopeName);
+    }
+
+    void GpuProfiler::endFrame() {
+        ENGINE_PROFILE_FUNCTION();
+
+        popScope();
+
+        if (m_Recording) {
+            auto& slot = m_Slots[m_CurrentSlot];
+            if (m_UseQueryBuffer) {
+                GLW_VALIDATE(slot.usedQueries <= m_MaxScopes * 2, "{} timestamp queries overflow the {} reserved per frame", slot.usedQueries, m_MaxScopes * 2);
+                size_t base = m_CurrentSlot * m_MaxScopes * 2;
+                for (unsigned int i = 0; i < slot.usedQueries; i++) {
+                    slot.queries[i]->writeResult(m_ResultBuffer.get(), (base + i) * sizeof(uint64_t));
+                }
+                glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+            }
+
+            slot.fence   = std::make_unique<glw::Fence>();
+            slot.pending = true;
+        }
+
+        m_Recording = false;
+        m_FrameNumber++;
+    }
+
+    void GpuProfiler::pushScope(const char* name) {
+        auto& slot = m_Slots[m_CurrentSlot];
+        // Every open scope still needs its end query, so those are kept in reserve.
+        if (!m_Recording || slot.usedQueries + 2 + m_OpenScopes > m_MaxScopes * 2) {
+            m_Stack.push_back(-1);
+            return;
+        }
+
+        int parent = -1;
+        int depth  = 0;
+        for (auto it = m_Stack.rbegin(); it != m_Stack.rend(); ++it) {
+            if (*it >= 0) {
+                parent = *it;
+                depth  = slot.scopes[*it].depth + 1;
+                break;
+            }
+        }
+
+        unsigned int query = allocateQuery(slot);
+        slot.queries[query]->counter();
+
+        m_Stack.push_back(static_cast<int>(slot.scopes.size()));
+        slot.scopes.push_back({name, parent, depth, query, query});
+        m_OpenScopes++;
+    }
+
+    void GpuProfiler::popScope() {
+        if (m_Stack.empty())
+            return;
+
+        int index = m_Stack.back();
+        m_Stack.pop_back();
+        if (index < 0)
+            return;
+
+        auto&        slot  = m_Slots[m_CurrentSlot];
+        unsigned int query = allocateQuery(slot);
+        slot.queries[query]->counter();
+        slot.scopes[index].endQuery = query;
+        m_OpenScopes--;
+    }
+
+    const GpuProfiler::Statistics* GpuProfiler::getStatistics(const std::string& name) const {
+        auto it = m_Statistics.find(name);
+        return it == m_Statistics.end() ? nullptr : &it->second;
+    }
+
+    void GpuProfiler::logLastFrame() const {
+        spdlog::info("GPU frame {}:", m_LastFrameNumber);
+        for (const auto& scope : m_LastFrame) {
+            spdlog::info("{:>{}}{}: {:.3f} ms", "", scope.depth * 2, scope.name, scope.durationMilliseconds);
+        }
+    }
+
+    void GpuProfiler::calibrate() {
+        GLint64 gpu;
+        glGetInteger64v(GL_TIMESTAMP, &gpu);
+        m_ClockOffset = static_cast<int64_t>(profiler::Now()) - gpu;
+    }
+
+    unsigned int GpuProfiler::allocateQuery(FrameSlot& slot) {
+        if (slot.usedQueries == slot.queries.size())
+            slot.queries.push_back(std::make_unique<glw::Query>(glw::Query::Type::Timestamp));
+
+        return slot.usedQueries++;
+    }
+
+    void GpuProfiler::resolve(FrameSlot& slot, size_t slotIndex) {
+        slot.pending = false;
+        slot.fence.reset();
+
+        if (slot.scopes.empty() || slot.frameNumber < m_LastFrameNumber)
+            return;
+
+        auto timestamp = [&](unsigned int query) -> uint64_t {
+            if (m_UseQueryBuffer)
+                return m_Results[slotIndex * m_MaxScopes * 2 + query];
+            return slot.queries[query]->getResult();
+        };
+
+        uint64_t origin = timestamp(slot.scopes.front().beginQuery);
+
+        m_LastFrame.clear();
+        m_LastFrame.reserve(slot.scopes.size());
+        for (const auto& scope : slot.scopes) {
+            uint64_t begin = timestamp(scope.beginQuery);
+            uint64_t end   = std::max(timestamp(scope.endQuery), begin);
+
+            ScopeResult result{};
+            result.name                 = scope.name;
+            result.parent               = scope.parent;
+            result.depth                = scope.depth;
+            result.startNanoseconds     = begin;
+            result.startMilliseconds    = static_cast<double>(begin - origin) * 1e-6;
+            result.durationMilliseconds = static_cast<double>(end - begin) * 1e-6;
+            m_LastFrame.push_back(result);
+
+            record(scope.name, result.durationMilliseconds);
+
+            if (m_Track)
+                profiler::Record(m_Track, scope.name, begin + m_ClockOffset, end + m_ClockOffset);
+        }
+
+        m_LastFrameNumber = slot.frameNumber;
+    }
+
+    void GpuProfiler::record(const char* name, double milliseconds) {
+        auto& history = m_History[name];
+        if (history.samples.size() < m_HistoryLength)
+            history.samples.push_back(milliseconds);
+        else
+            history.samples[history.next] = milliseconds;
+        history.next = (history.next + 1) % m_HistoryLength;
+
+        auto& stats   = m_Statistics[name];
+        stats.last    = milliseconds;
+        stats.samples = history.samples.size();
+        stats.min     = *std::min_element(history.samples.begin(), history.samples.end());
+        stats.max     = *std::max_element(history.samples.begin(), history.samples.end());
+
+        double sum = 0.0;
+        for (double s : history.samples) sum += s;
+        stats.average = sum / static_cast<double>(history.samples.size());
+    }
+
+} // namespace engine
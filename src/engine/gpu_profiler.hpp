@@ -0,0 +1,124 @@
+#pragma once
+
+#include "engine/gl.hpp"
+#include "engine/profiler.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+
+    // Brackets GPU work with GL_TIMESTAMP queries. Results are written by the GPU into a persistently mapped
+    // query buffer and read back `latency` frames later once the frame's fence has signalled, so the CPU never
+    // waits on query results.
+    class GpuProfiler {
+      public:
+        struct ScopeResult {
+            const char* name;
+            int         parent;
+            int         depth;
+            uint64_t    startNanoseconds;
+            double      startMilliseconds;
+            double      durationMilliseconds;
+        };
+
+        struct Statistics {
+            double last    = 0.0;
+            double average = 0.0;
+            double min     = 0.0;
+            double max     = 0.0;
+            size_t samples = 0;
+        };
+
+        class Scope {
+          public:
+            inline Scope(GpuProfiler& profiler, const char* name) : m_Profiler(profiler) { m_Profiler.pushScope(name); };
+            inline ~Scope() { m_Profiler.popScope(); };
+
+            Scope(const Scope&)            = delete;
+            Scope& operator=(const Scope&) = delete;
+
+          private:
+            GpuProfiler& m_Profiler;
+        };
+
+        explicit GpuProfiler(unsigned int latency = 3, unsigned int maxScopesPerFrame = 256, size_t historyLength = 120);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&)            = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        void beginFrame();
+        void endFrame();
+
+        void pushScope(const char* name);
+        void popScope();
+
+        // Scopes of the most recently resolved frame in pre-order; parent is an index into the same vector or -1.
+        [[nodiscard]] inline const std::vector<ScopeResult>& getLastFrame() const noexcept { return m_LastFrame; };
+        [[nodiscard]] inline uint64_t getLastFrameNumber() const noexcept { return m_LastFrameNumber; };
+
+        [[nodiscard]] const Statistics* getStatistics(const std::string& name) const;
+        [[nodiscard]] inline const std::unordered_map<std::string, Statistics>& getAllStatistics() const noexcept { return m_Statistics; };
+
+        void logLastFrame() const;
+
+        // Re-measures the offset between the GPU timestamp clock and profiler::Now() used to place GPU scopes on the
+        // CPU trace timeline. This is a synchronous glGet, so call it rarely (it runs once on construction).
+        void calibrate();
+
+      private:
+        struct ScopeRecord {
+            const char* name;
+            int         parent;
+            int         depth;
+            unsigned    beginQuery;
+            unsigned    endQuery;
+        };
+
+        struct FrameSlot {
+            std::vector<std::unique_ptr<glw::Query>> queries;
+            std::vector<ScopeRecord>                 scopes;
+            std::unique_ptr<glw::Fence>              fence;
+            unsigned int                             usedQueries = 0;
+            uint64_t                                 frameNumber = 0;
+            bool                                     pending     = false;
+        };
+
+        struct History {
+            std::vector<double> samples;
+            size_t              next = 0;
+        };
+
+        unsigned int allocateQuery(FrameSlot& slot);
+        void         resolve(FrameSlot& slot, size_t slotIndex);
+        void         record(const char* name, double milliseconds);
+
+        unsigned int m_MaxScopes;
+        size_t       m_HistoryLength;
+        bool         m_UseQueryBuffer;
+
+        std::vector<FrameSlot>        m_Slots;
+        std::unique_ptr<glw::Buffer>  m_ResultBuffer;
+        const uint64_t*               m_Results = nullptr;
+
+        size_t           m_CurrentSlot = 0;
+        uint64_t         m_FrameNumber = 0;
+        bool             m_Recording   = false;
+        std::vector<int> m_Stack;
+        unsigned int     m_OpenScopes  = 0; // Recorded scopes on m_Stack, each owed an end query
+
+        std::vector<ScopeResult>                    m_LastFrame;
+        uint64_t                                    m_LastFrameNumber = 0;
+        std::unordered_map<std::string, Statistics> m_Statistics;
+        std::unordered_map<std::string, History>    m_History;
+
+        profiler::Track* m_Track       = nullptr;
+        int64_t          m_ClockOffset = 0;
+    };
+
+} // namespace engine
+
+#define ENGINE_GPU_SCOPE(profiler, name) ::engine::GpuProfiler::Scope ENGINE_CONCAT(gpu_scope_, __LINE__)(profiler, name)
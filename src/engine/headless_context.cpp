@@ -0,0 +1,132 @@
+#include "engine/headless_context.hpp"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace engine {
+    static bool HasEglExtension(const char* extensions, const char* name) {
+        if (!extensions)
+            return false;
+
+        size_t length = std::strlen(name);
+        for (const char* p = std::strstr(extensions, name); p; p = std::strstr(p + length, name)) {
+            if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0'))
+                return true;
+        }
+        return false;
+    }
+
+    static EGLDisplay OpenDisplay() {
+        const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        if (HasEglExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+            auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+            if (getPlatformDisplay) {
+                EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+                if (display != EGL_NO_DISPLAY)
+                    return display;
+            }
+        }
+
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    HeadlessContext::HeadlessContext() : HeadlessContext(Settings{}) {}
+
+    HeadlessContext::HeadlessContext(const Settings& settings) {
+        if (settings.forceSoftware)
+            setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+
+        EGLDisplay display = OpenDisplay();
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+            throw std::runtime_error("Failed to initialize EGL display");
+        m_Display = display;
+
+        // The destructor does not run when the constructor throws, so release what was created so far here.
+        try {
+            if (!eglBindAPI(EGL_OPENGL_API))
+                throw std::runtime_error("EGL implementation does not support desktop OpenGL");
+
+            bool surfaceless = HasEglExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+
+            const EGLint configAttribs[] = {
+                EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_RED_SIZE, 8,
+                EGL_GREEN_SIZE, 8,
+                EGL_BLUE_SIZE, 8,
+                EGL_ALPHA_SIZE, 8,
+                EGL_NONE,
+            };
+
+            EGLConfig config;
+            EGLint    configCount = 0;
+            if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0)
+                throw std::runtime_error("No suitable EGL config for a headless OpenGL context");
+
+            // Software rasterizers may stop short of the requested version; glw needs at least 4.5 for direct state access.
+            for (int minor = settings.versionMinor; m_Context == EGL_NO_CONTEXT && (minor >= 5 || minor == settings.versionMinor); minor--) {
+                const EGLint contextAttribs[] = {
+                    EGL_CONTEXT_MAJOR_VERSION, settings.versionMajor,
+                    EGL_CONTEXT_MINOR_VERSION, minor,
+                    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                    EGL_CONTEXT_OPENGL_DEBUG, settings.debug ? EGL_TRUE : EGL_FALSE,
+                    EGL_NONE,
+                };
+
+                m_Context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+            }
+
+            if (m_Context == EGL_NO_CONTEXT)
+                throw std::runtime_error("Failed to create OpenGL " + std::to_string(settings.versionMajor) + "." + std::to_string(settings.versionMinor) +
+                                         " core context through EGL");
+
+            if (!surfaceless) {
+                const EGLint pbufferAttribs[] = {
+                    EGL_WIDTH, settings.width,
+                    EGL_HEIGHT, settings.height,
+                    EGL_NONE,
+                };
+
+                m_Surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+                if (m_Surface == EGL_NO_SURFACE)
+                    throw std::runtime_error("Failed to create EGL pbuffer surface");
+            }
+
+            makeCurrent();
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    HeadlessContext::~HeadlessContext() {
+        release();
+    }
+
+    void HeadlessContext::release() noexcept {
+        if (!m_Display)
+            return;
+
+        eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_Surface)
+            eglDestroySurface(m_Display, m_Surface);
+        if (m_Context)
+            eglDestroyContext(m_Display, m_Context);
+        eglTerminate(m_Display);
+
+        m_Display = nullptr;
+        m_Context = nullptr;
+        m_Surface = nullptr;
+    }
+
+    void HeadlessContext::makeCurrent() const {
+        EGLSurface surface = m_Surface ? m_Surface : EGL_NO_SURFACE;
+        if (!eglMakeCurrent(m_Display, surface, surface, m_Context))
+            throw std::runtime_error("Failed to make headless context current");
+    }
+
+    GLADapiproc HeadlessContext::GetProcAddress(const char* name) {
+        return reinterpret_cast<GLADapiproc>(eglGetProcAddress(name));
+    }
+
+} // namespace engine
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "engine/engine.hpp"
+
+namespace engine {
+
+    // An offscreen OpenGL context created through EGL (Mesa surfaceless platform when available, pbuffer otherwise),
+    // for benchmarks and regression runs on machines without a display. Render into framebuffer objects; the
+    // surfaceless path has no default framebuffer.
+    class HeadlessContext {
+      public:
+        struct Settings {
+            int  versionMajor  = 4;
+            int  versionMinor  = 6;
+            int  width         = 1;
+            int  height        = 1;
+            bool debug         = false;
+            bool forceSoftware = false;
+        };
+
+        HeadlessContext();
+        explicit HeadlessContext(const Settings& settings);
+        ~HeadlessContext();
+
+        HeadlessContext(const HeadlessContext&)            = delete;
+        HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+        void makeCurrent() const;
+
+        [[nodiscard]] inline bool isSurfaceless() const noexcept { return m_Surface == nullptr; };
+
+        // Suitable for glw::load(ProcLoader).
+        static GLADapiproc GetProcAddress(const char* name);
+
+      private:
+        void release() noexcept;
+
+        void* m_Display = nullptr;
+        void* m_Context = nullptr;
+        void* m_Surface = nullptr;
+    };
+
+} // namespace engine
@@ -0,0 +1,135 @@
+#include "engine/profiler.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace engine::profiler {
+    struct Track {
+        std::unique_ptr<Event[]> events = std::make_unique<Event[]>(TrackCapacity);
+        std::atomic<uint64_t>    head   = 0;
+        uint64_t                 tail   = 0;
+        uint32_t                 id     = 0;
+        std::string              name;
+    };
+
+    struct CollectedEvent {
+        Event    event;
+        uint32_t track;
+    };
+
+    struct Session {
+        std::mutex                          mutex;
+        std::vector<std::unique_ptr<Track>> tracks;
+        std::vector<CollectedEvent>         events;
+    };
+
+    static Session& GetSession() {
+        static Session session;
+        return session;
+    }
+
+    Track* CreateTrack(const std::string& name) {
+        auto&            session = GetSession();
+        std::scoped_lock lock(session.mutex);
+
+        auto track  = std::make_unique<Track>();
+        track->id   = static_cast<uint32_t>(session.tracks.size());
+        track->name = name;
+        session.tracks.push_back(std::move(track));
+        return session.tracks.back().get();
+    }
+
+    Track* GetThreadTrack() {
+        thread_local Track* track = CreateTrack("Thread " + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) & 0xFFFF));
+        return track;
+    }
+
+    void Record(Track* track, const char* name, uint64_t start, uint64_t end) noexcept {
+        uint64_t head                               = track->head.load(std::memory_order_relaxed);
+        track->events[head & (TrackCapacity - 1)]   = {name, start, end};
+        track->head.store(head + 1, std::memory_order_release);
+    }
+
+    void SetThreadName(const std::string& name) {
+        auto&            session = GetSession();
+        Track*           track   = GetThreadTrack();
+        std::scoped_lock lock(session.mutex);
+        track->name = name;
+    }
+
+    void Flush() {
+        auto&            session = GetSession();
+        std::scoped_lock lock(session.mutex);
+
+        for (const auto& track : session.tracks) {
+            uint64_t head  = track->head.load(std::memory_order_acquire);
+            uint64_t from  = std::max(track->tail, head > TrackCapacity ? head - TrackCapacity : 0);
+            size_t   first = session.events.size();
+            for (uint64_t i = from; i < head; i++) {
+                session.events.push_back({track->events[i & (TrackCapacity - 1)], track->id});
+            }
+
+            // The owning thread keeps recording while we copy. Once it has moved on by the time the copy is done, the
+            // oldest slots may have been rewritten mid-copy (including the one it is writing now), so those are dropped.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t newHead = track->head.load(std::memory_order_relaxed);
+            uint64_t valid   = newHead + 1 > TrackCapacity ? newHead + 1 - TrackCapacity : 0;
+            if (valid > from) {
+                size_t dropped = static_cast<size_t>(std::min(valid, head) - from);
+                session.events.erase(session.events.begin() + static_cast<std::ptrdiff_t>(first),
+                                     session.events.begin() + static_cast<std::ptrdiff_t>(first + dropped));
+            }
+            track->tail = head;
+        }
+    }
+
+    void Clear() {
+        Flush();
+
+        auto&            session = GetSession();
+        std::scoped_lock lock(session.mutex);
+        session.events.clear();
+    }
+
+    bool WriteChromeTrace(const std::string& path) {
+        Flush();
+
+        auto&            session = GetSession();
+        std::scoped_lock lock(session.mutex);
+
+        uint64_t origin = UINT64_MAX;
+        for (const auto& e : session.events) origin = std::min(origin, e.event.start);
+
+        nlohmann::json events = nlohmann::json::array();
+        for (const auto& track : session.tracks) {
+            events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", track->id}, {"args", {{"name", track->name}}}});
+        }
+
+        for (const auto& e : session.events) {
+            events.push_back({
+                {"name", e.event.name},
+                {"cat", session.tracks[e.track]->name},
+                {"ph", "X"},
+                {"pid", 0},
+                {"tid", e.track},
+                {"ts", static_cast<double>(e.event.start - origin) * 1e-3},
+                {"dur", static_cast<double>(e.event.end - e.event.start) * 1e-3},
+            });
+        }
+
+        std::ofstream file(path);
+        if (!file) {
+            spdlog::error("Failed to open trace file '{}'", path);
+            return false;
+        }
+
+        file << nlohmann::json{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}};
+        return true;
+    }
+} // namespace engine::profiler
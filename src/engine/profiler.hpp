@@ -0,0 +1,64 @@
+#pragma once
+
+#include "engine/engine.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace engine::profiler {
+    struct Event {
+        const char* name;
+        uint64_t    start;
+        uint64_t    end;
+    };
+
+    struct Track;
+
+    inline uint64_t Now() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Each thread records into its own ring buffer without taking locks; Flush() drains every ring into the session.
+    // Rings hold TrackCapacity events, so Flush() must run at least that often (once per frame is plenty). Events that
+    // a recording thread overwrites while Flush() is copying them are dropped rather than returned torn.
+    inline constexpr size_t TrackCapacity = 1 << 16;
+
+    Track* GetThreadTrack();
+    Track* CreateTrack(const std::string& name);
+
+    void Record(Track* track, const char* name, uint64_t start, uint64_t end) noexcept;
+
+    void SetThreadName(const std::string& name);
+
+    void Flush();
+    void Clear();
+
+    bool WriteChromeTrace(const std::string& path);
+
+    class ScopedEvent {
+      public:
+        inline explicit ScopedEvent(const char* name) noexcept : m_Name(name), m_Start(Now()) {};
+        inline ~ScopedEvent() { Record(GetThreadTrack(), m_Name, m_Start, Now()); };
+
+        ScopedEvent(const ScopedEvent&)            = delete;
+        ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+      private:
+        const char* m_Name;
+        uint64_t    m_Start;
+    };
+} // namespace engine::profiler
+
+// Scope names must outlive the session (string literals or __func__).
+#ifdef ENGINE_ENABLE_PROFILING
+#define ENGINE_PROFILE_SCOPE(name) ::engine::profiler::ScopedEvent ENGINE_CONCAT(profile_scope_, __LINE__)(name)
+#define ENGINE_PROFILE_FUNCTION() ENGINE_PROFILE_SCOPE(__func__)
+#define ENGINE_PROFILE_THREAD(name) ::engine::profiler::SetThreadName(name)
+#define ENGINE_PROFILE_FLUSH() ::engine::profiler::Flush()
+#else
+#define ENGINE_PROFILE_SCOPE(name) ((void)0)
+#define ENGINE_PROFILE_FUNCTION() ((void)0)
+#define ENGINE_PROFILE_THREAD(name) ((void)0)
+#define ENGINE_PROFILE_FLUSH() ((void)0)
+#endif
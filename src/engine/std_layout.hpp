@@ -0,0 +1,209 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace glw {
+    // GLSL block layouts. std140 rounds array strides and struct alignment up to 16 bytes; std430 (shader storage
+    // blocks only) packs scalar and vec2 arrays tightly.
+    enum class LayoutRule {
+        Std140,
+        Std430,
+    };
+
+    // Describes a C++ struct's members, in GLSL declaration order, to Layout. Specialise it with GLW_STD_LAYOUT.
+    template<typename T>
+    struct LayoutMembers;
+
+    // Alignment, Size and a packed write() of T under Rule. Structs additionally expose per-member Offsets. Types
+    // without a specialisation (e.g. size_t, pointers) fail to compile rather than silently mismatching the shader.
+    template<LayoutRule Rule, typename T>
+    struct Layout;
+
+    template<typename T>
+    using Std140 = Layout<LayoutRule::Std140, T>;
+
+    template<typename T>
+    using Std430 = Layout<LayoutRule::Std430, T>;
+
+    template<typename T>
+    concept LayoutScalar = std::same_as<T, float> || std::same_as<T, int32_t> || std::same_as<T, uint32_t> || std::same_as<T, double>;
+
+    namespace detail {
+        constexpr size_t AlignTo(size_t value, size_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        template<typename T>
+        struct MemberType;
+
+        template<typename C, typename M>
+        struct MemberType<M C::*> {
+            using type = M;
+        };
+
+        template<typename T>
+        inline constexpr bool IsScalarOrVector = LayoutScalar<T>;
+
+        template<glm::length_t L, typename T, glm::qualifier Q>
+        inline constexpr bool IsScalarOrVector<glm::vec<L, T, Q>> = LayoutScalar<T>;
+
+        template<LayoutRule Rule, typename Element, size_t Count>
+        struct ArrayLayout {
+            using ElementLayout = Layout<Rule, Element>;
+
+            static constexpr size_t Alignment = Rule == LayoutRule::Std140 ? AlignTo(ElementLayout::Alignment, 16) : ElementLayout::Alignment;
+            static constexpr size_t Stride    = AlignTo(ElementLayout::Size, Alignment);
+            static constexpr size_t Size      = Stride * Count;
+
+            // Also used for glm matrices, whose operator[] returns a column.
+            template<typename Value>
+            static void write(std::byte* destination, const Value& value) {
+                if constexpr (IsScalarOrVector<Element> && Stride == sizeof(Element) && ElementLayout::Size == sizeof(Element)) {
+                    std::memcpy(destination, &value[0], Size);
+                } else {
+                    for (size_t i = 0; i < Count; i++) ElementLayout::write(destination + i * Stride, value[static_cast<int>(i)]);
+                }
+            };
+        };
+    } // namespace detail
+
+    template<LayoutRule Rule, LayoutScalar T>
+    struct Layout<Rule, T> {
+        static constexpr size_t Alignment = sizeof(T);
+        static constexpr size_t Size      = sizeof(T);
+
+        static void write(std::byte* destination, const T& value) { std::memcpy(destination, &value, sizeof(T)); };
+    };
+
+    // GLSL bools occupy 4 bytes.
+    template<LayoutRule Rule>
+    struct Layout<Rule, bool> {
+        static constexpr size_t Alignment = 4;
+        static constexpr size_t Size      = 4;
+
+        static void write(std::byte* destination, bool value) {
+            uint32_t word = value ? 1u : 0u;
+            std::memcpy(destination, &word, sizeof(word));
+        };
+    };
+
+    // A vec3 aligns like a vec4 but only occupies three components, so a following scalar packs into its last slot.
+    template<LayoutRule Rule, glm::length_t L, LayoutScalar T, glm::qualifier Q>
+    struct Layout<Rule, glm::vec<L, T, Q>> {
+        static constexpr size_t Alignment = sizeof(T) * (L == 3 ? 4 : L);
+        static constexpr size_t Size      = sizeof(T) * L;
+
+        static void write(std::byte* destination, const glm::vec<L, T, Q>& value) { std::memcpy(destination, &value[0], Size); };
+    };
+
+    // Column-major matrices are laid out as an array of column vectors.
+    template<LayoutRule Rule, glm::length_t C, glm::length_t R, LayoutScalar T, glm::qualifier Q>
+    struct Layout<Rule, glm::mat<C, R, T, Q>> : detail::ArrayLayout<Rule, glm::vec<R, T, Q>, C> {};
+
+    template<LayoutRule Rule, typename T, size_t N>
+    struct Layout<Rule, T[N]> : detail::ArrayLayout<Rule, T, N> {};
+
+    template<LayoutRule Rule, typename T, size_t N>
+    struct Layout<Rule, std::array<T, N>> : detail::ArrayLayout<Rule, T, N> {};
+
+    template<LayoutRule Rule, typename T>
+        requires requires { LayoutMembers<T>::Members; }
+    struct Layout<Rule, T> {
+      private:
+        using MemberList = std::remove_cvref_t<decltype(LayoutMembers<T>::Members)>;
+
+        template<size_t I>
+        using MemberLayout = Layout<Rule, typename detail::MemberType<std::tuple_element_t<I, MemberList>>::type>;
+
+        static constexpr size_t Count = std::tuple_size_v<MemberList>;
+
+        struct Computed {
+            std::array<size_t, Count> offsets{};
+            size_t                    alignment = 1;
+            size_t                    end       = 0;
+        };
+
+        static constexpr Computed compute() {
+            Computed result;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((result.end = detail::AlignTo(result.end, MemberLayout<I>::Alignment), result.offsets[I] = result.end, result.end += MemberLayout<I>::Size,
+                  result.alignment = std::max(result.alignment, MemberLayout<I>::Alignment)),
+                 ...);
+            }(std::make_index_sequence<Count>{});
+
+            if (Rule == LayoutRule::Std140)
+                result.alignment = detail::AlignTo(result.alignment, 16);
+            return result;
+        };
+
+        static constexpr Computed Result = compute();
+
+      public:
+        static constexpr size_t                    Alignment = Result.alignment;
+        static constexpr size_t                    Size      = detail::AlignTo(Result.end, Alignment);
+        static constexpr std::array<size_t, Count> Offsets   = Result.offsets;
+
+        static void write(std::byte* destination, const T& value) {
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                (MemberLayout<I>::write(destination + Offsets[I], value.*std::get<I>(LayoutMembers<T>::Members)), ...);
+            }(std::make_index_sequence<Count>{});
+        };
+    };
+
+    // Packs `value` into `destination` (typically mapped buffer memory) at the offsets the shader expects. Padding
+    // bytes are left untouched.
+    template<LayoutRule Rule, typename T>
+    inline void WriteLayout(void* destination, const T& value) {
+        Layout<Rule, T>::write(static_cast<std::byte*>(destination), value);
+    }
+
+    namespace detail::layout_checks {
+        struct Light {
+            glm::vec3 position;
+            float     radius;
+            glm::vec4 color;
+            float     weights[3];
+        };
+
+        struct Scene {
+            Light     lights[2];
+            uint32_t  count;
+            glm::mat3 basis;
+        };
+    } // namespace detail::layout_checks
+} // namespace glw
+
+// Must be used at global scope, after the struct's definition.
+#define GLW_STD_LAYOUT(Type, ...)                                                                                                                    \
+    template<>                                                                                                                                       \
+    struct glw::LayoutMembers<Type> {                                                                                                                \
+        static constexpr auto Members = std::make_tuple(__VA_ARGS__);                                                                                \
+    }
+
+GLW_STD_LAYOUT(glw::detail::layout_checks::Light, &glw::detail::layout_checks::Light::position, &glw::detail::layout_checks::Light::radius,
+               &glw::detail::layout_checks::Light::color, &glw::detail::layout_checks::Light::weights);
+GLW_STD_LAYOUT(glw::detail::layout_checks::Scene, &glw::detail::layout_checks::Scene::lights, &glw::detail::layout_checks::Scene::count,
+               &glw::detail::layout_checks::Scene::basis);
+
+namespace glw::detail::layout_checks {
+    static_assert(Std140<glm::vec3>::Alignment == 16 && Std140<glm::vec3>::Size == 12);
+    static_assert(Std140<float[4]>::Size == 64 && Std430<float[4]>::Size == 16);
+    static_assert(Std140<glm::vec3[2]>::Size == 32 && Std430<glm::vec3[2]>::Size == 32);
+    static_assert(Std140<glm::mat2>::Size == 32 && Std430<glm::mat2>::Size == 16);
+    static_assert(Std140<glm::mat3>::Size == 48 && Std430<glm::mat3>::Size == 48);
+    static_assert(Std140<glm::mat4>::Size == 64 && Std430<glm::mat4>::Size == 64);
+
+    static_assert(Std140<Light>::Offsets == std::array<size_t, 4>{0, 12, 16, 32} && Std140<Light>::Size == 80);
+    static_assert(Std430<Light>::Offsets == std::array<size_t, 4>{0, 12, 16, 32} && Std430<Light>::Size == 48);
+    static_assert(Std140<Scene>::Offsets == std::array<size_t, 3>{0, 160, 176} && Std140<Scene>::Size == 224);
+    static_assert(Std430<Scene>::Offsets == std::array<size_t, 3>{0, 96, 112} && Std430<Scene>::Size == 160);
+} // namespace glw::detail::layout_checks
@@ -0,0 +1,166 @@
+#include "engine/transparency.hpp"
+#include "engine/profiler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace engine {
+    static constexpr uint32_t EndOfList = 0xFFFFFFFFu;
+
+    // Nodes are uvec4(half RG, half BA, depth bits, next).
+    static constexpr const char* ShaderInterfaceSource = R"(
+layout(early_fragment_tests) in;
+
+layout(binding = {0}, r32ui) uniform coherent uimage2D u_OitHeads;
+layout(std430, binding = {1}) writeonly buffer OitNodes {{ uvec4 u_OitNodes[]; }};
+layout(binding = {2}, offset = 0) uniform atomic_uint u_OitCounter;
+
+void oitInsert(vec4 color) {{
+    uint node = atomicCounterIncrement(u_OitCounter);
+    if (node >= uint(u_OitNodes.length()))
+        return;
+
+    uint next        = imageAtomicExchange(u_OitHeads, ivec2(gl_FragCoord.xy), node);
+    u_OitNodes[node] = uvec4(packHalf2x16(color.rg), packHalf2x16(color.ba), floatBitsToUint(gl_FragCoord.z), next);
+}}
+)";
+
+    static constexpr const char* ResolveVertexSource = R"(#version 450 core
+void main() {
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position   = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    // Gathers the maxLayers nearest fragments, sorts them near to far and composites them front to back.
+    static constexpr const char* ResolveFragmentSource = R"(#version 450 core
+layout(binding = {0}, r32ui) uniform readonly uimage2D u_OitHeads;
+layout(std430, binding = {1}) readonly buffer OitNodes {{ uvec4 u_OitNodes[]; }};
+
+out vec4 o_Color;
+
+void main() {{
+    uint  node = imageLoad(u_OitHeads, ivec2(gl_FragCoord.xy)).r;
+    vec4  colors[{2}];
+    float depths[{2}];
+    int   count = 0;
+    for (; node != 0xFFFFFFFFu; node = u_OitNodes[node].w) {{
+        uvec4 fragment = u_OitNodes[node];
+        vec4  color    = vec4(unpackHalf2x16(fragment.x), unpackHalf2x16(fragment.y));
+        float depth    = uintBitsToFloat(fragment.z);
+
+        if (count < {2}) {{
+            colors[count] = color;
+            depths[count] = depth;
+            count++;
+        }} else {{
+            // Full: the fragment replaces the farthest layer if it is nearer.
+            int farthest = 0;
+            for (int i = 1; i < {2}; i++)
+                if (depths[i] > depths[farthest])
+                    farthest = i;
+            if (depth < depths[farthest]) {{
+                colors[farthest] = color;
+                depths[farthest] = depth;
+            }}
+        }}
+    }}
+
+    for (int i = 1; i < count; i++) {{
+        vec4  color = colors[i];
+        float depth = depths[i];
+        int   j     = i - 1;
+        for (; j >= 0 && depths[j] > depth; j--) {{
+            colors[j + 1] = colors[j];
+            depths[j + 1] = depths[j];
+        }}
+        colors[j + 1] = color;
+        depths[j + 1] = depth;
+    }}
+
+    vec4 result = vec4(0.0);
+    for (int i = 0; i < count; i++) {{
+        result.rgb += (1.0 - result.a) * colors[i].a * colors[i].rgb;
+        result.a   += (1.0 - result.a) * colors[i].a;
+    }}
+    o_Color = result;
+}}
+)";
+
+    OrderIndependentTransparency::OrderIndependentTransparency(int width, int height, unsigned int averageLayers, unsigned int maxLayers)
+        : m_AverageLayers(std::max(1u, averageLayers)) {
+        auto fragment = fmt::format(ResolveFragmentSource, HeadImageUnit, NodeBinding, std::max(1u, maxLayers));
+        auto program  = glw::Program::create({{glw::Shader::Type::Vertex, ResolveVertexSource}, {glw::Shader::Type::Fragment, fragment}});
+        if (!program->isLinked())
+            throw std::runtime_error("Failed to build transparency resolve program: " + program->getInfoLog());
+
+        // The resolve output is premultiplied.
+        glw::PipelineState state;
+        state.blend.enabled  = true;
+        state.blend.srcColor = glw::BlendFactor::One;
+        state.blend.dstColor = glw::BlendFactor::OneMinusSrcAlpha;
+        state.blend.srcAlpha = glw::BlendFactor::One;
+        state.blend.dstAlpha = glw::BlendFactor::OneMinusSrcAlpha;
+        m_ResolvePipeline    = glw::Pipeline::create({program, state});
+
+        m_EmptyVertexArray = glw::VertexArray::create();
+        m_Counter          = glw::Buffer::createStorageUnique(sizeof(uint32_t), nullptr, glw::Buffer::StorageFlags::None);
+        resize(width, height);
+    }
+
+    void OrderIndependentTransparency::resize(int width, int height) {
+        // Compare the clamped size, and always allocate on the first call, even for a 0x0 request.
+        width  = std::max(width, 1);
+        height = std::max(height, 1);
+        if (m_Heads && width == m_Width && height == m_Height)
+            return;
+
+        m_Width        = width;
+        m_Height       = height;
+        m_NodeCapacity = static_cast<size_t>(m_Width) * static_cast<size_t>(m_Height) * m_AverageLayers;
+
+        m_Heads = std::make_unique<glw::GenericTexture>(glw::GenericTexture::Type::Texture2D);
+        m_Heads->setMemoryTag(glw::MemoryTag::RenderTarget);
+        m_Heads->storage2D(1, glw::InternalFormat::R32UI, m_Width, m_Height);
+
+        m_Nodes = glw::Buffer::createStorageUnique(m_NodeCapacity * 4 * sizeof(uint32_t), nullptr, glw::Buffer::StorageFlags::None);
+        m_Nodes->setMemoryTag(glw::MemoryTag::RenderTarget);
+    }
+
+    void OrderIndependentTransparency::bindResources() const {
+        m_Heads->bindImage(HeadImageUnit, 0, false, 0, glw::AccessMode::ReadWrite, glw::ImageFormat::R32UI);
+        m_Nodes->bindBase(glw::Buffer::Target::ShaderStorage, NodeBinding);
+        m_Counter->bindBase(glw::Buffer::Target::AtomicCounter, CounterBinding);
+    }
+
+    void OrderIndependentTransparency::begin() {
+        ENGINE_PROFILE_FUNCTION();
+
+        // The clears overwrite what the previous frame's transparent draws stored with incoherent atomics (marked by
+        // resolve()), which needs update barriers first. Later shader access is ordered with the clears by GL.
+        glw::InsertPendingBarriers(glw::BarrierBit::TextureUpdate | glw::BarrierBit::BufferUpdate);
+        m_Heads->clear(0, GL_RED_INTEGER, GL_UNSIGNED_INT, &EndOfList);
+        m_Counter->clear(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT);
+        bindResources();
+    }
+
+    void OrderIndependentTransparency::resolve(glw::StateCache& stateCache) {
+        ENGINE_PROFILE_FUNCTION();
+
+        // The transparent draws wrote the head image, the nodes and the counter, which are only ever read by this pass
+        // and cleared by begin(). Resolving needs the image and storage bits now; the update bits stay pending.
+        glw::MarkPendingWrites(glw::BarrierBit::ShaderImageAccess | glw::BarrierBit::ShaderStorage | glw::BarrierBit::TextureUpdate |
+                               glw::BarrierBit::BufferUpdate);
+        glw::InsertPendingBarriers(glw::BarrierBit::ShaderImageAccess | glw::BarrierBit::ShaderStorage);
+
+        bindResources();
+        stateCache.bind(m_ResolvePipeline);
+        m_EmptyVertexArray->bind();
+        glw::DrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    std::string OrderIndependentTransparency::getShaderInterface() {
+        return fmt::format(ShaderInterfaceSource, HeadImageUnit, NodeBinding, CounterBinding);
+    }
+
+} // namespace engine
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "engine/gl.hpp"
+#include "engine/gl_pipeline.hpp"
+
+#include <memory>
+#include <string>
+
+namespace engine {
+
+    // Order-independent transparency with per-pixel linked lists. Between begin() and resolve(), transparent shaders
+    // call oitInsert(color) (see getShaderInterface()) instead of writing a color: each fragment takes a node from an
+    // atomic counter, swaps itself in as the head of its pixel's list in an R32UI image and stores color, depth and the
+    // previous head. resolve() sorts every pixel's list by depth and blends it over the bound framebuffer, so
+    // transparent draws need no CPU-side sorting and intersecting surfaces blend correctly.
+    //
+    // Fragments beyond the node capacity (width * height * averageLayers) are dropped, and only the `maxLayers` nearest
+    // fragments of a pixel are composited.
+    class OrderIndependentTransparency {
+      public:
+        static constexpr unsigned int HeadImageUnit  = 0;
+        static constexpr unsigned int NodeBinding    = 0;
+        static constexpr unsigned int CounterBinding = 0;
+
+        OrderIndependentTransparency(int width, int height, unsigned int averageLayers = 4, unsigned int maxLayers = 16);
+
+        OrderIndependentTransparency(const OrderIndependentTransparency&)            = delete;
+        OrderIndependentTransparency& operator=(const OrderIndependentTransparency&) = delete;
+
+        void resize(int width, int height);
+
+        // Empties every list and binds the head image, node pool and counter for the transparent draws that follow.
+        // Every begin() after the first must follow a resolve(), which records the barriers the clears need.
+        void begin();
+
+        // Composites the lists with premultiplied alpha blending over the currently bound framebuffer.
+        void resolve(glw::StateCache& stateCache);
+
+        // GLSL to paste into transparent fragment shaders after the #version line. Declares early fragment tests, so
+        // occluded fragments never reach the lists, and `void oitInsert(vec4 color)` taking straight alpha.
+        [[nodiscard]] static std::string getShaderInterface();
+
+        [[nodiscard]] inline int getWidth() const noexcept { return m_Width; };
+        [[nodiscard]] inline int getHeight() const noexcept { return m_Height; };
+        [[nodiscard]] inline size_t getNodeCapacity() const noexcept { return m_NodeCapacity; };
+
+      private:
+        void bindResources() const;
+
+        int          m_Width         = 0;
+        int          m_Height        = 0;
+        unsigned int m_AverageLayers = 0;
+        size_t       m_NodeCapacity  = 0;
+
+        std::unique_ptr<glw::GenericTexture> m_Heads;
+        std::unique_ptr<glw::Buffer>         m_Nodes;
+        std::unique_ptr<glw::Buffer>         m_Counter;
+        std::shared_ptr<glw::Pipeline>       m_ResolvePipeline;
+        std::shared_ptr<glw::VertexArray>    m_EmptyVertexArray;
+    };
+
+} // namespace engine
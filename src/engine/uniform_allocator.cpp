@@ -0,0 +1,89 @@
+#include "engine/uniform_allocator.hpp"
+#include "engine/profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace engine {
+    static constexpr size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    UniformAllocator::UniformAllocator(size_t bytesPerFrame, unsigned int framesInFlight, Kind kind) : m_Fences(std::max(1u, framesInFlight)) {
+        GLenum alignmentQuery = GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT;
+        m_Target              = glw::Buffer::Target::Uniform;
+        if (kind == Kind::ShaderStorage) {
+            alignmentQuery = GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT;
+            m_Target       = glw::Buffer::Target::ShaderStorage;
+        }
+
+        m_Alignment     = static_cast<size_t>(std::max(1, glw::GetInteger(alignmentQuery)));
+        m_BytesPerFrame = AlignUp(bytesPerFrame, m_Alignment);
+
+        size_t size  = m_BytesPerFrame * m_Fences.size();
+        auto   flags = glw::Buffer::StorageFlags::MapWrite | glw::Buffer::StorageFlags::MapPersistent | glw::Buffer::StorageFlags::MapCoherent;
+        m_Buffer     = glw::Buffer::createStorageUnique(size, nullptr, flags);
+        m_Buffer->setMemoryTag(glw::MemoryTag::Uniform);
+        m_Mapped = static_cast<uint8_t*>(m_Buffer->map(GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, {0, size}));
+        if (!m_Mapped)
+            throw std::runtime_error("Failed to map uniform allocator buffer");
+    }
+
+    UniformAllocator::~UniformAllocator() {
+        if (m_Buffer)
+            m_Buffer->unmap();
+    }
+
+    void UniformAllocator::beginFrame() {
+        ENGINE_PROFILE_FUNCTION();
+
+        m_CurrentRegion = m_FrameNumber % m_Fences.size();
+        m_RegionStart   = m_CurrentRegion * m_BytesPerFrame;
+        m_Offset        = m_RegionStart;
+
+        // The GPU may still be reading this region from `framesInFlight` frames ago.
+        auto& fence = m_Fences[m_CurrentRegion];
+        if (fence && !fence->isSignaled()) {
+            m_Stalls++;
+            fence->wait(UINT64_MAX);
+        }
+        fence.reset();
+    }
+
+    void UniformAllocator::endFrame() {
+        m_Fences[m_CurrentRegion] = std::make_unique<glw::Fence>();
+        m_FrameNumber++;
+    }
+
+    UniformAllocator::Allocation UniformAllocator::allocate(size_t size) {
+        size_t offset = AlignUp(m_Offset, m_Alignment);
+        if (offset + size > m_RegionStart + m_BytesPerFrame)
+            throw std::runtime_error(fmt::format("Uniform allocator exhausted: {} bytes requested, {} of {} bytes used this frame", size,
+                                                 offset - m_RegionStart, m_BytesPerFrame));
+
+        m_Offset    = offset + size;
+        m_HighWater = std::max(m_HighWater, m_Offset - m_RegionStart);
+        return {{offset, size}, m_Mapped + offset};
+    }
+
+    engine::range<size_t> UniformAllocator::push(const void* data, size_t size) {
+        auto allocation = allocate(size);
+        std::memcpy(allocation.data, data, size);
+        captureWrite(allocation);
+        return allocation.range;
+    }
+
+    void UniformAllocator::captureWrite(const Allocation& allocation) const {
+#ifdef ENGINE_ENABLE_CAPTURE
+        glw::CaptureMappedWrite(m_Buffer.get(), allocation.range, allocation.data);
+#else
+        (void)allocation;
+#endif
+    }
+
+    void UniformAllocator::bind(unsigned int index, const engine::range<size_t>& range) {
+        m_Buffer->bindRange(m_Target, index, range);
+    }
+
+} // namespace engine
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "engine/gl.hpp"
+#include "engine/std_layout.hpp"
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace engine {
+
+    // Per-frame linear allocator for shader constants. One persistently mapped buffer is split into `framesInFlight`
+    // regions; allocations bump through the current region and are returned as ranges ready for Buffer::bindRange.
+    // beginFrame() only reuses a region after the fence placed by the endFrame() that last used it has signalled.
+    class UniformAllocator {
+      public:
+        enum class Kind {
+            Uniform,
+            ShaderStorage,
+        };
+
+        struct Allocation {
+            engine::range<size_t> range;
+            void*                 data;
+        };
+
+        explicit UniformAllocator(size_t bytesPerFrame, unsigned int framesInFlight = 3, Kind kind = Kind::Uniform);
+        ~UniformAllocator();
+
+        UniformAllocator(const UniformAllocator&)            = delete;
+        UniformAllocator& operator=(const UniformAllocator&) = delete;
+
+        void beginFrame();
+        void endFrame();
+
+        // Throws once the frame's region is exhausted. Writes through `data` are not captured; prefer push().
+        [[nodiscard]] Allocation allocate(size_t size);
+
+        engine::range<size_t> push(const void* data, size_t size);
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        engine::range<size_t> push(const T& value) {
+            return push(&value, sizeof(T));
+        };
+
+        template<typename T>
+        engine::range<size_t> push(const std::vector<T>& values) {
+            return push(values.data(), values.size() * sizeof(T));
+        };
+
+        // Packs `value` as std140 for uniform allocators and std430 for shader storage ones.
+        template<typename T>
+        engine::range<size_t> pushLayout(const T& value) {
+            if (m_Target == glw::Buffer::Target::ShaderStorage)
+                return pushLayout<glw::LayoutRule::Std430>(value);
+            return pushLayout<glw::LayoutRule::Std140>(value);
+        };
+
+        template<glw::LayoutRule Rule, typename T>
+        engine::range<size_t> pushLayout(const T& value) {
+            auto allocation = allocate(glw::Layout<Rule, T>::Size);
+            glw::WriteLayout<Rule>(allocation.data, value);
+            captureWrite(allocation);
+            return allocation.range;
+        };
+
+        void bind(unsigned int index, const engine::range<size_t>& range);
+
+        [[nodiscard]] inline glw::Buffer* getBuffer() const noexcept { return m_Buffer.get(); };
+        [[nodiscard]] inline glw::Buffer::Target getTarget() const noexcept { return m_Target; };
+        [[nodiscard]] inline size_t getAlignment() const noexcept { return m_Alignment; };
+        [[nodiscard]] inline size_t getCapacity() const noexcept { return m_BytesPerFrame; };
+        [[nodiscard]] inline size_t getUsed() const noexcept { return m_Offset - m_RegionStart; };
+        [[nodiscard]] inline size_t getHighWater() const noexcept { return m_HighWater; };
+        [[nodiscard]] inline uint64_t getStalls() const noexcept { return m_Stalls; };
+
+      private:
+        void captureWrite(const Allocation& allocation) const;
+
+        glw::Buffer::Target m_Target;
+        size_t              m_Alignment;
+        size_t              m_BytesPerFrame;
+
+        std::unique_ptr<glw::Buffer>             m_Buffer;
+        uint8_t*                                 m_Mapped = nullptr;
+        std::vector<std::unique_ptr<glw::Fence>> m_Fences;
+
+        size_t   m_CurrentRegion = 0;
+        size_t   m_RegionStart   = 0;
+        size_t   m_Offset        = 0;
+        size_t   m_HighWater     = 0;
+        uint64_t m_FrameNumber   = 0;
+        uint64_t m_Stalls        = 0;
+    };
+
+} // namespace engine